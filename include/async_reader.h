@@ -0,0 +1,243 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASYNC_READER_H_
+#define ASYNC_READER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "chunk_tag.h"
+#include "region_file_reader.h"
+#include "thread_pool.h"
+
+class async_reader {
+public:
+
+	/*
+	 * I/O backends (io_uring on linux, where available, otherwise a pool of threads issuing pread)
+	 */
+	enum BACKEND { PREAD = 0, IO_URING };
+
+	/*
+	 * Read completion, called on a decode worker with the worker's index and the data read
+	 */
+	typedef std::function<void(unsigned int, std::vector<char> &)> completion;
+
+	/*
+	 * Default number of reads kept in flight
+	 */
+	static const unsigned int DEFAULT_DEPTH = 64;
+
+private:
+
+	/*
+	 * Pending read
+	 */
+	struct request {
+
+		/*
+		 * File descriptor, offset and length to read
+		 */
+		int fd;
+		unsigned long long offset;
+		unsigned int length;
+
+		/*
+		 * Read completion
+		 */
+		completion func;
+	};
+
+	/*
+	 * io_uring state (opaque outside of linux builds)
+	 */
+	struct ring;
+
+	/*
+	 * Backend in use
+	 */
+	BACKEND backend;
+
+	/*
+	 * Number of reads kept in flight
+	 */
+	unsigned int depth;
+
+	/*
+	 * Open file descriptors, by path
+	 */
+	std::map<std::string, int> files;
+
+	/*
+	 * Reader lock (guards files, requests and counts)
+	 */
+	std::mutex lock;
+
+	/*
+	 * Reads not yet handed to a decode worker
+	 */
+	unsigned long long outstanding;
+
+	/*
+	 * Decode worker pool
+	 */
+	thread_pool pool;
+
+	/*
+	 * Pending reads, oldest first
+	 */
+	std::deque<request> requests;
+
+	/*
+	 * Signalled when reads are queued, and when all reads are handed to decode workers
+	 */
+	std::condition_variable ready, idle;
+
+	/*
+	 * io_uring state (NULL under the pread backend)
+	 */
+	std::unique_ptr<ring> uring;
+
+	/*
+	 * Reader stopping status
+	 */
+	bool stopping;
+
+	/*
+	 * I/O threads
+	 */
+	std::vector<std::thread> workers;
+
+	/*
+	 * Hand a finished read to a decode worker
+	 */
+	void complete(request &req, std::vector<char> &data, bool failed);
+
+	/*
+	 * Returns an open file descriptor for a given path
+	 */
+	int get_file(const std::string &path);
+
+	/*
+	 * Read the rest of a request's bytes with blocking preads, returning false on failure
+	 */
+	static bool read_fully(request &req, std::vector<char> &data, unsigned int &done);
+
+	/*
+	 * Run the pread backend's I/O loop
+	 */
+	void run_pread(void);
+
+	/*
+	 * Run the io_uring backend's I/O loop
+	 */
+	void run_uring(void);
+
+	/*
+	 * Set up io_uring, returning false if it is unavailable
+	 */
+	bool start_uring(void);
+
+	/*
+	 * Tear down io_uring
+	 */
+	void stop_uring(void);
+
+	/*
+	 * Take the oldest pending read, waiting for one unless told not to, returning false once stopping (or if none wait)
+	 */
+	bool take(request &req, bool block);
+
+	/*
+	 * Async reader constructor (not copyable)
+	 */
+	async_reader(const async_reader &other);
+
+	/*
+	 * Async reader assignment operator (not copyable)
+	 */
+	async_reader &operator=(const async_reader &other);
+
+public:
+
+	/*
+	 * Async reader constructor
+	 * (keeps up to depth reads in flight, with count decode workers; a count of 0 uses one per hardware thread)
+	 */
+	explicit async_reader(unsigned int depth = DEFAULT_DEPTH, unsigned int count = 0, BACKEND preferred = IO_URING);
+
+	/*
+	 * Async reader destructor
+	 * (waits for pending reads)
+	 */
+	virtual ~async_reader(void);
+
+	/*
+	 * Async reader equals operator
+	 */
+	bool operator==(const async_reader &other);
+
+	/*
+	 * Async reader not-equals operator
+	 */
+	bool operator!=(const async_reader &other) { return !(*this == other); }
+
+	/*
+	 * Returns a reader's backend
+	 */
+	BACKEND get_backend(void) { return backend; }
+
+	/*
+	 * Returns a reader's depth
+	 */
+	unsigned int get_depth(void) { return depth; }
+
+	/*
+	 * Queue a read of a byte range of a file, handing the data to a decode worker once read
+	 */
+	void read(const std::string &path, unsigned long long offset, unsigned int length, const completion &func);
+
+	/*
+	 * Queue a read of a single chunk at a given x, z coord, using an open region file reader's header, handing
+	 * the chunk to a decode worker once read and decoded (missing chunks are skipped, and readers opened on a
+	 * region source throw, having no file to read)
+	 */
+	void read_chunk(const std::shared_ptr<region_file_reader> &reader, unsigned int x, unsigned int z,
+			const std::function<void(unsigned int, chunk_tag &)> &func);
+
+	/*
+	 * Returns a string representation of an async reader
+	 */
+	std::string to_string(void);
+
+	/*
+	 * Wait until every queued read has been read and handed off, and every decode worker has finished,
+	 * rethrowing the first failure
+	 */
+	void wait(void);
+};
+
+#endif // ASYNC_READER_H_
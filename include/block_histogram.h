@@ -0,0 +1,136 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOCK_HISTOGRAM_H_
+#define BLOCK_HISTOGRAM_H_
+
+#include <bitset>
+#include <climits>
+#include <string>
+#include <vector>
+#include "parallel.h"
+#include "region.h"
+#include "region_dim.h"
+
+class block_histogram {
+private:
+
+	/*
+	 * Block counts, indexed by block id
+	 */
+	std::vector<unsigned long long> counts;
+
+public:
+
+	/*
+	 * Number of distinct block ids (8 bits of "Blocks", plus 4 bits of "Add")
+	 */
+	static const unsigned int ID_COUNT = 4096;
+
+	/*
+	 * Block histogram constructor
+	 */
+	block_histogram(void) : counts(ID_COUNT, 0) { return; }
+
+	/*
+	 * Block histogram constructor
+	 */
+	block_histogram(const block_histogram &other) : counts(other.counts) { return; }
+
+	/*
+	 * Block histogram destructor
+	 */
+	virtual ~block_histogram(void) { return; }
+
+	/*
+	 * Block histogram assignment operator
+	 */
+	block_histogram &operator=(const block_histogram &other);
+
+	/*
+	 * Block histogram equals operator
+	 */
+	bool operator==(const block_histogram &other);
+
+	/*
+	 * Block histogram not-equals operator
+	 */
+	bool operator!=(const block_histogram &other) { return !(*this == other); }
+
+	/*
+	 * Add another histogram's counts to a block histogram
+	 */
+	void add(const block_histogram &other);
+
+	/*
+	 * Reset a block histogram's counts
+	 */
+	void clear(void);
+
+	/*
+	 * Count the blocks of a region's filled chunks
+	 * (only blocks of stored sections are counted, so missing sections do not add to the air count)
+	 */
+	void count(region &reg, parallel::POLICY policy = parallel::SEQUENTIAL) {
+		count(reg, INT_MIN, INT_MAX, std::bitset<region_dim::CHUNK_COUNT>().set(), policy);
+	}
+
+	/*
+	 * Count the blocks of a region's filled chunks, limited to blocks with a world y coord in [min_y, max_y]
+	 * and to chunks whose index (z * 32 + x) is set in a given mask
+	 */
+	void count(region &reg, int min_y, int max_y, const std::bitset<region_dim::CHUNK_COUNT> &mask,
+			parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Count the blocks of a list of region files, one file at a time
+	 */
+	void count(const std::vector<std::string> &paths, parallel::POLICY policy = parallel::SEQUENTIAL) {
+		count(paths, INT_MIN, INT_MAX, std::bitset<region_dim::CHUNK_COUNT>().set(), policy);
+	}
+
+	/*
+	 * Count the blocks of a list of region files, one file at a time, limited to blocks with a world y coord
+	 * in [min_y, max_y] and to chunks whose index (z * 32 + x) is set in a given mask
+	 */
+	void count(const std::vector<std::string> &paths, int min_y, int max_y, const std::bitset<region_dim::CHUNK_COUNT> &mask,
+			parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Returns a block histogram's count for a given block id
+	 */
+	unsigned long long get_count(unsigned int id);
+
+	/*
+	 * Returns a block histogram's counts, indexed by block id
+	 */
+	const std::vector<unsigned long long> &get_counts(void) { return counts; }
+
+	/*
+	 * Returns a block histogram's total count
+	 */
+	unsigned long long get_total(void);
+
+	/*
+	 * Returns a string representation of a block histogram
+	 */
+	std::string to_string(void);
+};
+
+#endif // BLOCK_HISTOGRAM_H_
@@ -0,0 +1,147 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOUNDING_BOX_H_
+#define BOUNDING_BOX_H_
+
+#include <string>
+
+class bounding_box {
+private:
+
+	/*
+	 * Bounding box min/max world coords (inclusive)
+	 */
+	int max_x, max_y, max_z, min_x, min_y, min_z;
+
+public:
+
+	/*
+	 * Bounding box constructor
+	 */
+	bounding_box(void) : max_x(0), max_y(0), max_z(0), min_x(0), min_y(0), min_z(0) { return; }
+
+	/*
+	 * Bounding box constructor
+	 */
+	bounding_box(const bounding_box &other) : max_x(other.max_x), max_y(other.max_y), max_z(other.max_z),
+			min_x(other.min_x), min_y(other.min_y), min_z(other.min_z) { return; }
+
+	/*
+	 * Bounding box constructor
+	 * (corners may be given in any order)
+	 */
+	bounding_box(int x_1, int y_1, int z_1, int x_2, int y_2, int z_2);
+
+	/*
+	 * Bounding box destructor
+	 */
+	virtual ~bounding_box(void) { return; }
+
+	/*
+	 * Bounding box assignment operator
+	 */
+	bounding_box &operator=(const bounding_box &other);
+
+	/*
+	 * Bounding box equals operator
+	 */
+	bool operator==(const bounding_box &other);
+
+	/*
+	 * Bounding box not-equals operator
+	 */
+	bool operator!=(const bounding_box &other) { return !(*this == other); }
+
+	/*
+	 * Returns true if a bounding box contains a given world coord
+	 */
+	bool contains(int x, int y, int z) const;
+
+	/*
+	 * Returns a bounding box's depth (along z, in blocks)
+	 */
+	unsigned int get_depth(void) const { return (unsigned int) ((long long) max_z - min_z + 1); }
+
+	/*
+	 * Returns a bounding box's height (along y, in blocks)
+	 */
+	unsigned int get_height(void) const { return (unsigned int) ((long long) max_y - min_y + 1); }
+
+	/*
+	 * Returns the index of a given world coord within a dense array covering a bounding box,
+	 * indexed by (y * depth + z) * width + x relative to the box's min coord
+	 */
+	unsigned long long get_index(int x, int y, int z) const {
+		return ((unsigned long long) (y - min_y) * get_depth() + (unsigned long long) (z - min_z)) * get_width()
+				+ (unsigned long long) (x - min_x);
+	}
+
+	/*
+	 * Returns a bounding box's max x coord
+	 */
+	int get_max_x(void) const { return max_x; }
+
+	/*
+	 * Returns a bounding box's max y coord
+	 */
+	int get_max_y(void) const { return max_y; }
+
+	/*
+	 * Returns a bounding box's max z coord
+	 */
+	int get_max_z(void) const { return max_z; }
+
+	/*
+	 * Returns a bounding box's min x coord
+	 */
+	int get_min_x(void) const { return min_x; }
+
+	/*
+	 * Returns a bounding box's min y coord
+	 */
+	int get_min_y(void) const { return min_y; }
+
+	/*
+	 * Returns a bounding box's min z coord
+	 */
+	int get_min_z(void) const { return min_z; }
+
+	/*
+	 * Returns a bounding box's volume (in blocks)
+	 */
+	unsigned long long get_volume(void) const { return (unsigned long long) get_width() * get_height() * get_depth(); }
+
+	/*
+	 * Returns a bounding box's width (along x, in blocks)
+	 */
+	unsigned int get_width(void) const { return (unsigned int) ((long long) max_x - min_x + 1); }
+
+	/*
+	 * Returns the intersection of two bounding boxes, returning false if they do not intersect
+	 */
+	bool intersect(const bounding_box &other, bounding_box &result) const;
+
+	/*
+	 * Returns a string representation of a bounding box
+	 */
+	std::string to_string(void);
+};
+
+#endif // BOUNDING_BOX_H_
@@ -20,6 +20,7 @@
 #ifndef BYTE_STREAM_H_
 #define BYTE_STREAM_H_
 
+#include <algorithm>
 #include <cstdlib>
 #include <string>
 #include <vector>
@@ -48,20 +49,23 @@ private:
 	 */
 	template<class T>
 	unsigned int read_stream(T &var) {
-		std::vector<unsigned char> data;
+		unsigned long long value = 0;
+		unsigned char data[sizeof(T)];
 
-		// assign type T from stream
+		// assign type T from stream (into a fixed buffer, so reads do not allocate)
 		unsigned int width = sizeof(T);
 		for(unsigned int i = 0; i < width; ++i) {
 			if(available() == END_OF_STREAM)
 				return END_OF_STREAM;
-			data.push_back(buff.at(pos++));
+			data[i] = buff.at(pos++);
 		}
 		if(swap)
-			swap_endian(data);
-		var = 0;
+			std::reverse(data, data + width);
+
+		// widen before shifting, so values wider than an int are not truncated
 		for(unsigned int i = 0; i < width; ++i)
-			var |= (data.at(i) << (8 * ((width - 1) - i)));
+			value |= ((unsigned long long) data[i] << (8 * ((width - 1) - i)));
+		var = (T) value;
 		return SUCCESS;
 	}
 
@@ -71,17 +75,17 @@ private:
 	 */
 	template<class T>
 	unsigned int read_stream_float(T &var) {
-		std::vector<unsigned char> data;
+		unsigned char data[sizeof(T) + 1] = { 0 };
 
-		// assign type T from stream
+		// assign type T from stream (into a fixed, terminated buffer)
 		for(unsigned int i = 0; i < sizeof(T); ++i) {
 			if(available() == END_OF_STREAM)
 				return END_OF_STREAM;
-			data.push_back(buff.at(pos++));
+			data[i] = buff.at(pos++);
 		}
 		if(swap)
-			swap_endian(data);
-		var = atof((char *) data.data());
+			std::reverse(data, data + sizeof(T));
+		var = atof((char *) data);
 		return SUCCESS;
 	}
 
@@ -248,6 +252,11 @@ public:
 	 */
 	bool operator>>(double &output);
 
+	/*
+	 * Byte stream output of a given length
+	 */
+	bool read(char *output, unsigned int length);
+
 	/*
 	 * Returns the available bytes left in the stream
 	 */
@@ -293,6 +302,11 @@ public:
 	 */
 	void set_position(unsigned int pos) { this->pos = pos; }
 
+	/*
+	 * Exchange a streams buffer with a given buffer, resetting its position
+	 */
+	void swap_buffer(std::vector<char> &buff) { this->buff.swap(buff); pos = 0; }
+
 	/*
 	 * Sets a streams swap status
 	 */
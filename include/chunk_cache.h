@@ -0,0 +1,236 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHUNK_CACHE_H_
+#define CHUNK_CACHE_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include "chunk_tag.h"
+#include "world.h"
+
+class chunk_cache {
+public:
+
+	/*
+	 * Cache key (region x, z coord and chunk index within the region)
+	 */
+	typedef std::tuple<int, int, unsigned int> key;
+
+	/*
+	 * Default cache budget (in bytes)
+	 */
+	static const unsigned long long DEFAULT_BUDGET = 256ULL * 1024 * 1024;
+
+private:
+
+	/*
+	 * Cached chunk
+	 */
+	struct entry {
+
+		/*
+		 * Cached chunk tag
+		 */
+		std::shared_ptr<chunk_tag> tag;
+
+		/*
+		 * Memory held by the chunk tag (in bytes)
+		 */
+		unsigned long long size;
+
+		/*
+		 * Pin count
+		 */
+		unsigned int pins;
+
+		/*
+		 * Referenced since the hand last passed
+		 */
+		bool referenced;
+
+		/*
+		 * Position in the clock ring
+		 */
+		std::list<key>::iterator position;
+	};
+
+	/*
+	 * Cache budget and current size (in bytes)
+	 */
+	unsigned long long budget, size;
+
+	/*
+	 * Cached chunks, by key
+	 */
+	std::map<key, entry> entries;
+
+	/*
+	 * Cache hand, sweeping over the clock ring
+	 */
+	std::list<key>::iterator hand;
+
+	/*
+	 * Cache hit and miss counts
+	 */
+	unsigned long long hits, misses;
+
+	/*
+	 * Cache lock (guards all cache state)
+	 */
+	std::mutex lock;
+
+	/*
+	 * Cached chunk keys, in insertion order (the clock ring)
+	 */
+	std::list<key> ring;
+
+	/*
+	 * Cache source world
+	 */
+	world *wld;
+
+	/*
+	 * Evict unpinned chunks, in clock order, until the cache fits its budget (lock must be held)
+	 */
+	void evict(void);
+
+	/*
+	 * Returns a cached chunk at a given world chunk coord, reading it on a miss (pinning it if requested)
+	 */
+	std::shared_ptr<chunk_tag> fetch(int c_x, int c_z, bool pin);
+
+	/*
+	 * Returns the cache key of a given world chunk coord
+	 */
+	static key get_key(int c_x, int c_z);
+
+	/*
+	 * Remove a cached chunk (lock must be held)
+	 */
+	void remove(std::map<key, entry>::iterator iter);
+
+public:
+
+	/*
+	 * Chunk cache constructor
+	 */
+	chunk_cache(void) : budget(DEFAULT_BUDGET), size(0), hits(0), misses(0), wld(NULL) { hand = ring.end(); }
+
+	/*
+	 * Chunk cache constructor
+	 * (cached chunks are not shared with the copy)
+	 */
+	chunk_cache(const chunk_cache &other) : budget(other.budget), size(0), hits(0), misses(0), wld(other.wld) { hand = ring.end(); }
+
+	/*
+	 * Chunk cache constructor
+	 */
+	explicit chunk_cache(world &wld, unsigned long long budget = DEFAULT_BUDGET) : budget(budget), size(0), hits(0), misses(0),
+			wld(&wld) { hand = ring.end(); }
+
+	/*
+	 * Chunk cache destructor
+	 */
+	virtual ~chunk_cache(void) { return; }
+
+	/*
+	 * Chunk cache assignment operator
+	 */
+	chunk_cache &operator=(const chunk_cache &other);
+
+	/*
+	 * Chunk cache equals operator
+	 */
+	bool operator==(const chunk_cache &other);
+
+	/*
+	 * Chunk cache not-equals operator
+	 */
+	bool operator!=(const chunk_cache &other) { return !(*this == other); }
+
+	/*
+	 * Remove all of a cache's unpinned chunks
+	 */
+	void clear(void);
+
+	/*
+	 * Returns true if a chunk at a given world chunk coord is cached
+	 */
+	bool contains(int c_x, int c_z);
+
+	/*
+	 * Returns a chunk at a given world chunk coord, reading it into the cache on a miss,
+	 * or NULL if the chunk does not exist (safe to call concurrently; the chunk stays valid while held,
+	 * even once evicted)
+	 */
+	std::shared_ptr<chunk_tag> get(int c_x, int c_z) { return fetch(c_x, c_z, false); }
+
+	/*
+	 * Returns a cache's budget (in bytes)
+	 */
+	unsigned long long get_budget(void);
+
+	/*
+	 * Returns a cache's chunk count
+	 */
+	unsigned int get_count(void);
+
+	/*
+	 * Returns a cache's hit count
+	 */
+	unsigned long long get_hits(void);
+
+	/*
+	 * Returns a cache's miss count
+	 */
+	unsigned long long get_misses(void);
+
+	/*
+	 * Returns the memory held by a cache's chunks (in bytes)
+	 */
+	unsigned long long get_size(void);
+
+	/*
+	 * Returns a chunk at a given world chunk coord, as get does, pinning it in the cache until unpinned
+	 * (pins nest; pinned chunks may hold the cache over its budget)
+	 */
+	std::shared_ptr<chunk_tag> pin(int c_x, int c_z) { return fetch(c_x, c_z, true); }
+
+	/*
+	 * Sets a cache's budget (in bytes), evicting chunks as needed
+	 */
+	void set_budget(unsigned long long budget);
+
+	/*
+	 * Returns a string representation of a chunk cache
+	 */
+	std::string to_string(void);
+
+	/*
+	 * Unpin a chunk at a given world chunk coord
+	 */
+	void unpin(int c_x, int c_z);
+};
+
+#endif // CHUNK_CACHE_H_
@@ -26,9 +26,14 @@ class chunk_info {
 private:
 
 	/*
-	 * Time last modified, offset, and data length
+	 * Time last modified, and data length
 	 */
-	unsigned int modified, offset, length;
+	unsigned int modified, length;
+
+	/*
+	 * File offset (raw sector offset/count, or data position once read)
+	 */
+	unsigned long long offset;
 
 	/*
 	 * Compression type
@@ -40,22 +45,22 @@ public:
 	/*
 	 * Compression types
 	 */
-	enum TYPE { GZIP = 1, ZLIB };
+	enum TYPE { GZIP = 1, ZLIB, EXTERNAL = 0x80 };
 
 	/*
 	 * Chunk info constructor
 	 */
-	chunk_info(void) : modified(0), offset(0), length(0), type(GZIP) { return; }
+	chunk_info(void) : modified(0), length(0), offset(0), type(GZIP) { return; }
 
 	/*
 	 * Chunk info constructor
 	 */
-	chunk_info(const chunk_info &other) : modified(other.modified), offset(other.offset), length(other.length), type(other.type) { return; }
+	chunk_info(const chunk_info &other) : modified(other.modified), length(other.length), offset(other.offset), type(other.type) { return; }
 
 	/*
 	 * Chunk info constructor
 	 */
-	chunk_info(unsigned int offset, unsigned int length, char type, unsigned int modified) : modified(modified), offset(offset), length(length), type(type) { return; }
+	chunk_info(unsigned long long offset, unsigned int length, char type, unsigned int modified) : modified(modified), length(length), offset(offset), type(type) { return; }
 
 	/*
 	 * Chunk info destructor
@@ -95,13 +100,18 @@ public:
 	/*
 	 * Return a chunk's file offset
 	 */
-	unsigned int get_offset(void) { return offset; }
+	unsigned long long get_offset(void) { return offset; }
 
 	/*
 	 * Return a chunk's compression type
 	 */
 	char get_type(void) { return type; }
 
+	/*
+	 * Returns true if a chunk's data is stored in an external (.mcc) file
+	 */
+	bool is_external(void) { return ((unsigned char) type & EXTERNAL) != 0; }
+
 	/*
 	 * Set a chunk's data length
 	 */
@@ -115,7 +125,7 @@ public:
 	/*
 	 * Set a chunk's file offset
 	 */
-	void set_offset(unsigned int offset) { this->offset = offset; }
+	void set_offset(unsigned long long offset) { this->offset = offset; }
 
 	/*
 	 * Set a chunk's compression type
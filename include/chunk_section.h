@@ -0,0 +1,133 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHUNK_SECTION_H_
+#define CHUNK_SECTION_H_
+
+#include <string>
+#include <vector>
+#include "chunk_tag.h"
+#include "region_dim.h"
+#include "tag/byte_array_tag.h"
+#include "tag/list_tag.h"
+
+class chunk_section {
+private:
+
+	/*
+	 * Section block tags (low 8 bits, and optional high 4 bits, of each block id)
+	 */
+	byte_array_tag *add, *blocks;
+
+	/*
+	 * Section y coord (in sections)
+	 */
+	int y;
+
+	/*
+	 * Returns a chunk's section list ("Sections" under "Level", or "sections" at the root), or NULL if it has none
+	 */
+	static const list_tag *get_section_list(const chunk_tag &tag);
+
+public:
+
+	/*
+	 * Chunk section constructor
+	 */
+	chunk_section(void) : add(NULL), blocks(NULL), y(0) { return; }
+
+	/*
+	 * Chunk section constructor
+	 */
+	chunk_section(const chunk_section &other) : add(other.add), blocks(other.blocks), y(other.y) { return; }
+
+	/*
+	 * Chunk section constructor
+	 */
+	chunk_section(int y, byte_array_tag *blocks, byte_array_tag *add) : add(add), blocks(blocks), y(y) { return; }
+
+	/*
+	 * Chunk section destructor
+	 */
+	virtual ~chunk_section(void) { return; }
+
+	/*
+	 * Chunk section assignment operator
+	 */
+	chunk_section &operator=(const chunk_section &other);
+
+	/*
+	 * Chunk section equals operator
+	 */
+	bool operator==(const chunk_section &other);
+
+	/*
+	 * Chunk section not-equals operator
+	 */
+	bool operator!=(const chunk_section &other) { return !(*this == other); }
+
+	/*
+	 * Returns a section's all-air status
+	 */
+	bool empty(void);
+
+	/*
+	 * Returns a section's block id at a given index
+	 */
+	int get_block_at(unsigned int index);
+
+	/*
+	 * Returns a section's block id at a given b coord
+	 */
+	int get_block_at(unsigned int b_x, unsigned int b_y, unsigned int b_z);
+
+	/*
+	 * Returns a section's block ids, indexed by (y * 16 + z) * 16 + x
+	 */
+	void get_blocks(int (&ids)[region_dim::SECTION_BLOCK_COUNT]);
+
+	/*
+	 * Collect the y coords (in sections) of a chunk's sections that carry block data, in either block encoding,
+	 * in ascending order
+	 */
+	static void get_section_coords(const chunk_tag &tag, std::vector<int> &coords);
+
+	/*
+	 * Collect a chunk's sections that carry block data, in ascending y order
+	 */
+	static void get_sections(const chunk_tag &tag, std::vector<chunk_section> &sections);
+
+	/*
+	 * Returns true if any of a chunk's sections store palette block states ("BlockStates" or "block_states"),
+	 * which get_sections does not decode
+	 */
+	static bool has_palette(const chunk_tag &tag);
+
+	/*
+	 * Returns a section's y coord (in sections)
+	 */
+	int get_y(void) { return y; }
+
+	/*
+	 * Returns a string representation of a chunk section
+	 */
+	std::string to_string(void);
+};
+
+#endif // CHUNK_SECTION_H_
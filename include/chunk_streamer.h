@@ -0,0 +1,183 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHUNK_STREAMER_H_
+#define CHUNK_STREAMER_H_
+
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "async_reader.h"
+#include "chunk_tag.h"
+#include "world.h"
+
+class chunk_streamer {
+public:
+
+	/*
+	 * Chunk callback, called with a chunk's world chunk coord
+	 */
+	typedef std::function<void(int, int, chunk_tag &)> callback;
+
+	/*
+	 * World chunk coord (x, z)
+	 */
+	typedef std::pair<int, int> coord;
+
+	/*
+	 * Default number of chunk reads kept in flight
+	 */
+	static const unsigned int DEFAULT_WINDOW = 32;
+
+private:
+
+	/*
+	 * Streamer center (in world chunk coords) and radius (in chunks)
+	 */
+	int center_x, center_z;
+	unsigned int radius;
+
+	/*
+	 * Chunk callback
+	 */
+	callback func;
+
+	/*
+	 * Chunks being read, and chunks delivered (or found missing) within range
+	 */
+	std::set<coord> in_flight, loaded;
+
+	/*
+	 * Streamer lock (guards the center, queue, chunk sets and stopping flag)
+	 */
+	std::mutex lock;
+
+	/*
+	 * Chunks waiting to be read, farthest first
+	 */
+	std::vector<coord> queue;
+
+	/*
+	 * Streamer reader
+	 */
+	async_reader reader;
+
+	/*
+	 * Set once the streamer is being destroyed, so reads in flight are dropped and no more are issued
+	 */
+	bool stopping;
+
+	/*
+	 * Max number of chunk reads kept in flight
+	 */
+	unsigned int window;
+
+	/*
+	 * Streamer world
+	 */
+	world &wld;
+
+	/*
+	 * Returns true if a chunk lies within range of the center (lock must be held)
+	 */
+	bool in_range(const coord &chunk);
+
+	/*
+	 * Read or decode a finished chunk read
+	 */
+	void finish(const coord &chunk, const std::shared_ptr<region_file_reader> &region, unsigned int x, unsigned int z,
+			std::vector<char> &data);
+
+	/*
+	 * Issue reads of the nearest queued chunks, up to the window
+	 * (regions are resolved outside the lock, since opening a reader reads its header)
+	 */
+	void pump(void);
+
+	/*
+	 * Chunk streamer constructor (not copyable)
+	 */
+	chunk_streamer(const chunk_streamer &other);
+
+	/*
+	 * Chunk streamer assignment operator (not copyable)
+	 */
+	chunk_streamer &operator=(const chunk_streamer &other);
+
+public:
+
+	/*
+	 * Chunk streamer constructor
+	 * (count decode workers; a count of 0 uses one per hardware thread)
+	 */
+	chunk_streamer(world &wld, const callback &func, unsigned int window = DEFAULT_WINDOW, unsigned int count = 0);
+
+	/*
+	 * Chunk streamer destructor
+	 * (waits for reads in flight, dropping their chunks)
+	 */
+	virtual ~chunk_streamer(void);
+
+	/*
+	 * Chunk streamer equals operator
+	 */
+	bool operator==(const chunk_streamer &other) { return this == &other; }
+
+	/*
+	 * Chunk streamer not-equals operator
+	 */
+	bool operator!=(const chunk_streamer &other) { return !(*this == other); }
+
+	/*
+	 * Returns a streamer's loaded chunk count (delivered or missing, within range)
+	 */
+	unsigned int get_loaded_count(void);
+
+	/*
+	 * Returns a streamer's queued chunk count
+	 */
+	unsigned int get_queued_count(void);
+
+	/*
+	 * Returns true if a chunk at a given world chunk coord has been delivered (or found missing) within range
+	 */
+	bool is_loaded(int c_x, int c_z);
+
+	/*
+	 * Move a streamer's center (in world chunk coords) and radius (in chunks): queues every chunk within the radius
+	 * not yet loaded, nearest first, and drops queued, in-flight and loaded chunks that fall out of range
+	 * (chunks are delivered to the callback concurrently, from decode workers, as they decode)
+	 */
+	void set_center(int c_x, int c_z, unsigned int radius);
+
+	/*
+	 * Returns a string representation of a chunk streamer
+	 */
+	std::string to_string(void);
+
+	/*
+	 * Wait until every chunk within range has been delivered, rethrowing the first failure
+	 */
+	void wait(void);
+};
+
+#endif // CHUNK_STREAMER_H_
@@ -33,27 +33,39 @@ private:
 	 */
 	compound_tag root;
 
+	/*
+	 * Chunk modified flag
+	 */
+	bool modified;
+
+	/*
+	 * Chunk original compressed data and compression type (empty if not retained)
+	 */
+	std::vector<char> original;
+	char original_type;
+
 	/*
 	 * Returns a chunk tag sub-tag at a given name helper
 	 */
-	void get_tag_by_name_helper(const std::string &name, generic_tag *tag, std::vector<generic_tag *> &tags);
+	static void get_tag_by_name_helper(const std::string &name, generic_tag *tag, std::vector<generic_tag *> &tags);
 
 public:
 
 	/*
 	 * Chunk tag constructor
 	 */
-	chunk_tag(void) { return; }
+	chunk_tag(void) : modified(false), original_type(0) { return; }
 
 	/*
 	 * Chunk tag constructor
 	 */
-	chunk_tag(const chunk_tag &other) : root(other.root) { return; }
+	chunk_tag(const chunk_tag &other) : root(other.root), modified(other.modified), original(other.original),
+			original_type(other.original_type) { return; }
 
 	/*
 	 * Chunk tag constructor
 	 */
-	explicit chunk_tag(const compound_tag &root) : root(root) { return; }
+	explicit chunk_tag(const compound_tag &root) : root(root), modified(false), original_type(0) { return; }
 
 	/*
 	 * Chunk tag destructor
@@ -80,6 +92,11 @@ public:
 	 */
 	void clean_root(void);
 
+	/*
+	 * Clear a chunk tag's tags and original data, keeping the storage they held for reuse
+	 */
+	void clear(void);
+
 	/*
 	 * Clean chunk tag (recursively)
 	 */
@@ -113,19 +130,82 @@ public:
 	std::vector<char> get_data(void) { return root.get_data(false); }
 
 	/*
-	 * Return a chunk tag's root tag
+	 * Return a chunk tag's level tag (the root tag, for chunks without one), for changing
+	 * (marks the chunk modified, releasing its original data)
+	 */
+	compound_tag &get_level_tag(void);
+
+	/*
+	 * Return a chunk tag's level tag (the root tag, for chunks without one), for reading
 	 */
-	compound_tag &get_root_tag(void) { return root; }
+	const compound_tag &get_level_tag(void) const;
 
 	/*
-	 * Returns a chunk tag sub-tag at a given name
+	 * Return a chunk tag's original compressed data, as read (empty if not retained)
+	 */
+	const std::vector<char> &get_original(void) { return original; }
+
+	/*
+	 * Return a chunk tag's original compression type
+	 */
+	char get_original_type(void) { return original_type; }
+
+	/*
+	 * Return a chunk tag's root tag, for changing
+	 * (marks the chunk modified, releasing its original data)
+	 */
+	compound_tag &get_root_tag(void);
+
+	/*
+	 * Return a chunk tag's root tag, for reading
+	 */
+	const compound_tag &get_root_tag(void) const { return root; }
+
+	/*
+	 * Return the memory held by a chunk tag's tags and original data (in bytes)
+	 */
+	unsigned long long get_size(void);
+
+	/*
+	 * Returns a chunk tag sub-tag at a given name, for changing
+	 * (marks the chunk modified, releasing its original data)
 	 */
 	std::vector<generic_tag *> get_sub_tag_by_name(const std::string &name);
 
+	/*
+	 * Returns a chunk tag sub-tag at a given name, for reading
+	 */
+	std::vector<generic_tag *> get_sub_tag_by_name(const std::string &name) const;
+
+	/*
+	 * Return the memory held by a tag and its sub-tags (in bytes, recursively)
+	 */
+	static unsigned long long get_tag_size(generic_tag *tag);
+
+	/*
+	 * Returns true if a chunk tag still holds its original compressed data, unmodified
+	 */
+	bool has_original(void) { return !modified && !original.empty(); }
+
+	/*
+	 * Returns true if a chunk tag has been marked modified
+	 */
+	bool is_modified(void) { return modified; }
+
+	/*
+	 * Sets a chunk tag's modified flag (marking a chunk modified releases its original data)
+	 */
+	void set_modified(bool modified);
+
+	/*
+	 * Sets a chunk tag's original compressed data and compression type, clearing its modified flag
+	 */
+	void set_original(const std::vector<char> &original, char type);
+
 	/*
 	 * Sets a chunk tag's root tag
 	 */
-	void set_root_tag(const compound_tag &root) { this->root = root; }
+	void set_root_tag(const compound_tag &root);
 
 	/*
 	 * Returns a string representation of a chunk tag
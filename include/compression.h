@@ -21,6 +21,7 @@
 #define COMPRESSION_H_
 
 #include <vector>
+#include "parallel.h"
 
 class compression {
 public:
@@ -30,10 +31,54 @@ public:
 	 */
 	static const unsigned int SEG_SIZE = 16384;
 
+	/*
+	 * Block deflate block size, and the dictionary size each block is primed with (the deflate window)
+	 */
+	static const unsigned int BLOCK_SIZE = 131072;
+	static const unsigned int DICT_SIZE = 32768;
+
+	/*
+	 * Room left past deflateBound for a sync flush marker
+	 */
+	static const unsigned int SYNC_SIZE = 16;
+
+private:
+
+	/*
+	 * Returns the length of a given block of a buffer being block deflated
+	 */
+	static unsigned int block_length(unsigned int size, unsigned int block) {
+		return (size - (block * BLOCK_SIZE)) < BLOCK_SIZE ? (size - (block * BLOCK_SIZE)) : BLOCK_SIZE;
+	}
+
+public:
+
+	/*
+	 * Zlib compression levels
+	 */
+	static const int MIN_LEVEL = 1;
+	static const int MAX_LEVEL = 9;
+
+	/*
+	 * Zlib compression strategies
+	 */
+	enum STRATEGY { DEFAULT_STRATEGY = 0, FILTERED, HUFFMAN_ONLY, RLE, FIXED };
+
 	/*
 	 * Deflate a char buffer
 	 */
-	static bool deflate_(std::vector<char> &data);
+	static bool deflate_(std::vector<char> &data) { return deflate_(data, MAX_LEVEL, DEFAULT_STRATEGY); }
+
+	/*
+	 * Deflate a char buffer with a given level (0-9) and strategy
+	 */
+	static bool deflate_(std::vector<char> &data, int level, STRATEGY strategy);
+
+	/*
+	 * Deflate a char buffer with a given level (0-9) and strategy, as independently deflated blocks
+	 * (under the parallel policy, concurrently) stitched into a single zlib stream
+	 */
+	static bool deflate_blocks_(std::vector<char> &data, int level, STRATEGY strategy, parallel::POLICY policy);
 
 	/*
 	 * Inflate a char buffer
@@ -0,0 +1,233 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPRESSION_POLICY_H_
+#define COMPRESSION_POLICY_H_
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include "compression.h"
+
+class compression_policy {
+public:
+
+	/*
+	 * Level selection modes: a fixed level, a level tuned toward a throughput target, or a level chosen per chunk
+	 */
+	enum MODE { LEVEL = 0, THROUGHPUT, ADAPTIVE };
+
+	/*
+	 * Chunks smaller than this (in bytes) are deflated at the fastest level, under the adaptive mode
+	 */
+	static const unsigned int SMALL_SIZE = 8192;
+
+	/*
+	 * Bytes sampled from larger chunks to estimate their ratio, under the adaptive mode
+	 */
+	static const unsigned int SAMPLE_SIZE = 16384;
+
+	/*
+	 * Chunks at least this large (in bytes) are deflated in blocks, concurrently, by default
+	 */
+	static const unsigned int PARALLEL_SIZE = 1048576;
+
+private:
+
+	/*
+	 * Policy mode
+	 */
+	MODE mode;
+
+	/*
+	 * Policy level (the fixed level, the highest level used by the throughput and adaptive modes)
+	 * and current level (under the throughput mode)
+	 */
+	int level, current;
+
+	/*
+	 * Policy strategy
+	 */
+	compression::STRATEGY strategy;
+
+	/*
+	 * Throughput target (input bytes per second, under the throughput mode)
+	 */
+	double target;
+
+	/*
+	 * Sampled ratio (compressed / uncompressed) at or above which larger chunks are deflated at the fastest level,
+	 * under the adaptive mode
+	 */
+	double threshold;
+
+	/*
+	 * Size (in bytes) at which chunks are deflated in blocks, concurrently (0 to disable)
+	 */
+	unsigned int parallel_size;
+
+	/*
+	 * Policy statistics: chunks deflated, input and output bytes, and time spent (in seconds)
+	 */
+	unsigned long long count, bytes_in, bytes_out;
+	double time;
+
+	/*
+	 * Policy lock (guards the current level and statistics)
+	 */
+	std::mutex lock;
+
+	/*
+	 * Choose the level for a chunk
+	 */
+	int choose_level(const std::vector<char> &data);
+
+public:
+
+	/*
+	 * Compression policy constructor
+	 */
+	explicit compression_policy(MODE mode = LEVEL, int level = compression::MAX_LEVEL,
+			compression::STRATEGY strategy = compression::DEFAULT_STRATEGY);
+
+	/*
+	 * Compression policy constructor
+	 */
+	compression_policy(const compression_policy &other);
+
+	/*
+	 * Compression policy destructor
+	 */
+	virtual ~compression_policy(void) { return; }
+
+	/*
+	 * Compression policy assignment operator
+	 */
+	compression_policy &operator=(const compression_policy &other);
+
+	/*
+	 * Compression policy equals operator
+	 */
+	bool operator==(const compression_policy &other);
+
+	/*
+	 * Compression policy not-equals operator
+	 */
+	bool operator!=(const compression_policy &other) { return !(*this == other); }
+
+	/*
+	 * Deflate a char buffer at the level chosen by a compression policy, recording statistics
+	 * (safe to call concurrently)
+	 */
+	bool deflate(std::vector<char> &data);
+
+	/*
+	 * Returns a compression policy's deflated chunk count
+	 */
+	unsigned long long get_count(void);
+
+	/*
+	 * Returns a compression policy's uncompressed and compressed byte counts
+	 */
+	unsigned long long get_bytes_in(void);
+	unsigned long long get_bytes_out(void);
+
+	/*
+	 * Returns a compression policy's level
+	 */
+	int get_level(void) { return level; }
+
+	/*
+	 * Returns a compression policy's mode
+	 */
+	MODE get_mode(void) { return mode; }
+
+	/*
+	 * Returns a compression policy's parallel size
+	 */
+	unsigned int get_parallel_size(void) { return parallel_size; }
+
+	/*
+	 * Returns a compression policy's achieved ratio (compressed / uncompressed)
+	 */
+	double get_ratio(void);
+
+	/*
+	 * Returns a compression policy's strategy
+	 */
+	compression::STRATEGY get_strategy(void) { return strategy; }
+
+	/*
+	 * Returns a compression policy's throughput target (input bytes per second)
+	 */
+	double get_target(void) { return target; }
+
+	/*
+	 * Returns a compression policy's adaptive ratio threshold
+	 */
+	double get_threshold(void) { return threshold; }
+
+	/*
+	 * Returns a compression policy's time spent deflating (in seconds)
+	 */
+	double get_time(void);
+
+	/*
+	 * Clear a compression policy's statistics
+	 */
+	void reset(void);
+
+	/*
+	 * Sets a compression policy's level (0-9)
+	 */
+	void set_level(int level);
+
+	/*
+	 * Sets a compression policy's mode
+	 */
+	void set_mode(MODE mode) { this->mode = mode; }
+
+	/*
+	 * Sets a compression policy's parallel size (chunks at least this large are deflated in blocks, concurrently,
+	 * 0 to disable)
+	 */
+	void set_parallel_size(unsigned int parallel_size) { this->parallel_size = parallel_size; }
+
+	/*
+	 * Sets a compression policy's strategy
+	 */
+	void set_strategy(compression::STRATEGY strategy) { this->strategy = strategy; }
+
+	/*
+	 * Sets a compression policy's throughput target (input bytes per second)
+	 */
+	void set_target(double target) { this->target = target; }
+
+	/*
+	 * Sets a compression policy's adaptive ratio threshold
+	 */
+	void set_threshold(double threshold) { this->threshold = threshold; }
+
+	/*
+	 * Returns a string representation of a compression policy
+	 */
+	std::string to_string(void);
+};
+
+#endif // COMPRESSION_POLICY_H_
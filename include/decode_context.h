@@ -0,0 +1,140 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DECODE_CONTEXT_H_
+#define DECODE_CONTEXT_H_
+
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "byte_stream.h"
+
+class decode_context {
+private:
+
+	/*
+	 * Inflate stream (initialized on first use, then reset between chunks)
+	 */
+	z_stream inflater;
+	bool initialized;
+
+	/*
+	 * Inflate output buffer (exchanged with the data inflated, so neither buffer is released)
+	 */
+	std::vector<char> buffer;
+
+	/*
+	 * Raw chunk data buffer
+	 */
+	std::vector<char> raw;
+
+	/*
+	 * Parse stream (holds each chunk's inflated data while it is parsed)
+	 */
+	byte_stream stream;
+
+	/*
+	 * Decode statistics: chunks inflated, and compressed and inflated byte counts
+	 */
+	unsigned long long count, bytes_in, bytes_out;
+
+	/*
+	 * Decode context constructor (not copyable)
+	 */
+	decode_context(const decode_context &other);
+
+	/*
+	 * Decode context assignment operator (not copyable)
+	 */
+	decode_context &operator=(const decode_context &other);
+
+public:
+
+	/*
+	 * Decode context constructor
+	 */
+	decode_context(void);
+
+	/*
+	 * Decode context destructor
+	 */
+	virtual ~decode_context(void);
+
+	/*
+	 * Decode context equals operator
+	 */
+	bool operator==(const decode_context &other) { return this == &other; }
+
+	/*
+	 * Decode context not-equals operator
+	 */
+	bool operator!=(const decode_context &other) { return !(*this == other); }
+
+	/*
+	 * Returns a decode context's compressed byte count
+	 */
+	unsigned long long get_bytes_in(void) { return bytes_in; }
+
+	/*
+	 * Returns a decode context's inflated byte count
+	 */
+	unsigned long long get_bytes_out(void) { return bytes_out; }
+
+	/*
+	 * Returns a decode context's inflated chunk count
+	 */
+	unsigned long long get_count(void) { return count; }
+
+	/*
+	 * Returns the calling thread's decode context
+	 */
+	static decode_context &get_local(void);
+
+	/*
+	 * Returns a decode context's raw chunk data buffer
+	 */
+	std::vector<char> &get_raw(void) { return raw; }
+
+	/*
+	 * Returns a decode context's parse stream
+	 */
+	byte_stream &get_stream(void) { return stream; }
+
+	/*
+	 * Inflate a char buffer in place, reusing a decode context's inflate stream and output buffer
+	 */
+	bool inflate(std::vector<char> &data);
+
+	/*
+	 * Clear a decode context's statistics
+	 */
+	void reset(void);
+
+	/*
+	 * Release a decode context's buffers and inflate stream
+	 */
+	void release(void);
+
+	/*
+	 * Returns a string representation of a decode context
+	 */
+	std::string to_string(void);
+};
+
+#endif // DECODE_CONTEXT_H_
@@ -0,0 +1,88 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HEIGHTMAP_H_
+#define HEIGHTMAP_H_
+
+#include <string>
+#include "chunk_tag.h"
+#include "parallel.h"
+#include "region.h"
+#include "region_dim.h"
+
+class heightmap {
+private:
+
+	/*
+	 * Block classification flags
+	 */
+	static const unsigned char FLAG_FLUID = 0x1;
+	static const unsigned char FLAG_NON_AIR = 0x2;
+	static const unsigned char FLAG_OPAQUE = 0x4;
+	static const unsigned char FLAG_SOLID = 0x8;
+
+	/*
+	 * Returns the block classification flags, indexed by block id
+	 */
+	static const unsigned char *get_flags(void);
+
+public:
+
+	/*
+	 * Height map types
+	 * (legacy "HeightMap", and the "Heightmaps" entries of newer chunks)
+	 */
+	enum TYPE { HEIGHT_MAP = 0x1, MOTION_BLOCKING = 0x2, OCEAN_FLOOR = 0x4, WORLD_SURFACE = 0x8 };
+
+	/*
+	 * Number of height map types
+	 */
+	static const unsigned int TYPE_COUNT = 4;
+
+	/*
+	 * Entry width (in bits) of packed height maps
+	 */
+	static const unsigned int PACKED_WIDTH = 9;
+
+	/*
+	 * Compute a chunk's height maps of the given types from its section block data,
+	 * where heights[i] holds the type (1 << i), indexed by z * 16 + x
+	 * (only block id ("Blocks") sections are decoded; chunks storing palette block states throw)
+	 */
+	static void compute(const chunk_tag &tag, unsigned int types, int (&heights)[TYPE_COUNT][region_dim::BLOCK_COUNT]);
+
+	/*
+	 * Recompute a chunk's height maps of the given types, writing them back into the chunk
+	 * (newer types are only written into an existing "Heightmaps" tag; chunks storing palette block states throw)
+	 */
+	static void generate(chunk_tag &tag, unsigned int types);
+
+	/*
+	 * Recompute the height maps of the given types for every filled chunk in a region
+	 * (chunks storing palette block states are left untouched)
+	 */
+	static void generate(region &reg, unsigned int types, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Return the tag name of a height map type
+	 */
+	static std::string type_to_string(TYPE type);
+};
+
+#endif // HEIGHTMAP_H_
@@ -0,0 +1,47 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKED_ARRAY_H_
+#define PACKED_ARRAY_H_
+
+#include <vector>
+
+class packed_array {
+public:
+
+	/*
+	 * Returns the entry width (in bits) of a packed array holding a given number of entries,
+	 * or 0 if the array length matches no known layout
+	 */
+	static unsigned int get_width(const std::vector<long> &data, unsigned int count, bool &spanning);
+
+	/*
+	 * Pack a given number of entries into a packed array of a given entry width
+	 * (entries either span long boundaries, or are padded to them)
+	 */
+	static void pack(const int *values, unsigned int count, unsigned int width, bool spanning, std::vector<long> &data);
+
+	/*
+	 * Unpack a given number of entries from a packed array
+	 * (entries either span long boundaries, or are padded to them)
+	 */
+	static void unpack(const std::vector<long> &data, unsigned int count, int *values);
+};
+
+#endif // PACKED_ARRAY_H_
@@ -0,0 +1,52 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <functional>
+
+class parallel {
+public:
+
+	/*
+	 * Execution policies
+	 */
+	enum POLICY { SEQUENTIAL = 0, PARALLEL };
+
+	/*
+	 * Invoke a function for each index in [begin, end) using a given policy
+	 * (under the parallel policy, the function may be called concurrently)
+	 */
+	static void for_each(unsigned int begin, unsigned int end, const std::function<void(unsigned int)> &func, POLICY policy);
+
+	/*
+	 * Invoke a function for each index in [begin, end), along with the index of the worker calling it,
+	 * using a given policy (worker indices are in [0, get_thread_count()), and no two concurrent calls share one)
+	 */
+	static void for_each_worker(unsigned int begin, unsigned int end, const std::function<void(unsigned int, unsigned int)> &func,
+			POLICY policy);
+
+	/*
+	 * Returns the number of worker threads used by the parallel policy
+	 */
+	static unsigned int get_thread_count(void);
+};
+
+#endif // PARALLEL_H_
@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 #include "chunk_tag.h"
+#include "parallel.h"
 #include "region_dim.h"
 #include "region_header.h"
 
@@ -86,6 +87,11 @@ public:
 	 */
 	bool operator!=(const region &other) { return !(*this == other); }
 
+	/*
+	 * Clear a region's header and chunks, keeping the storage held by its chunk tags for reuse
+	 */
+	void clear(void);
+
 	/*
 	 * Generate a new region
 	 */
@@ -93,9 +99,24 @@ public:
 
 	/*
 	 * Generate a new chunk in a region
+	 * (the chunk is only marked filled; its sector layout is computed once, when the region is written)
 	 */
 	static void generate_chunk(unsigned int x, unsigned int z, region &reg);
 
+	/*
+	 * Generate new chunks in a region at every index, as copies of a given prototype chunk
+	 * (under the parallel policy, chunks are copied concurrently)
+	 */
+	static void generate_chunks(chunk_tag &prototype, region &reg, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Generate new chunks in a region at given indices, as copies of a given prototype chunk,
+	 * setting each copy's "xPos" and "zPos" tags (if present) to its world chunk coord
+	 * (under the parallel policy, chunks are copied concurrently)
+	 */
+	static void generate_chunks(chunk_tag &prototype, const std::vector<unsigned int> &indices, region &reg,
+			parallel::POLICY policy = parallel::SEQUENTIAL);
+
 	/*
 	 * Returns a region's header
 	 */
@@ -131,6 +152,11 @@ public:
 	 */
 	void set_header(const region_header &header) { this->header = header; }
 
+	/*
+	 * Marks a region's chunk filled, leaving its sector layout to the writer
+	 */
+	void set_filled(unsigned int index);
+
 	/*
 	 * Sets a region's tags
 	 */
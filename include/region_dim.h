@@ -23,6 +23,21 @@
 class region_dim {
 public:
 
+	/*
+	 * Maximum number of biome cells per chunk (3D biomes)
+	 */
+	static const unsigned int BIOME_COUNT = 1024;
+
+	/*
+	 * Biome cell height of a chunk (3D biomes)
+	 */
+	static const unsigned int BIOME_HEIGHT = 64;
+
+	/*
+	 * Biome cell width of a chunk (3D biomes)
+	 */
+	static const unsigned int BIOME_WIDTH = 4;
+
 	/*
 	 * Maximum number of surface blocks per chunk
 	 */
@@ -43,6 +58,11 @@ public:
 	 */
 	static const unsigned int CHUNK_COUNT = 1024;
 
+	/*
+	 * Maximum number of sectors a single chunk may span in a region file (larger chunks are stored externally)
+	 */
+	static const unsigned int CHUNK_SECTOR_COUNT = 255;
+
 	/*
 	 * Chunk width of a region
 	 */
@@ -53,10 +73,30 @@ public:
 	 */
 	static const unsigned int HEADER_OFFSET = 8192;
 
+	/*
+	 * Block width of a region
+	 */
+	static const unsigned int REGION_WIDTH = 512;
+
+	/*
+	 * Maximum sector offset within a region file
+	 */
+	static const unsigned int SECTOR_OFFSET_MAX = 0xffffff;
+
 	/*
 	 * Region file sector size
 	 */
 	static const unsigned int SECTOR_SIZE = 4096;
+
+	/*
+	 * Maximum number of blocks per chunk section
+	 */
+	static const unsigned int SECTION_BLOCK_COUNT = 4096;
+
+	/*
+	 * Block height of a chunk section
+	 */
+	static const unsigned int SECTION_HEIGHT = 16;
 };
 
 #endif // REGION_DIM_H_
@@ -22,6 +22,7 @@
 
 #include <boost/regex.hpp>
 #include <string>
+#include <vector>
 #include "region.h"
 
 class region_file {
@@ -110,6 +111,16 @@ public:
 	 */
 	void generate_chunk(unsigned int x, unsigned int z) { region::generate_chunk(x, z, reg); };
 
+	/*
+	 * Returns the path of a chunk's external (.mcc) file, alongside a region file
+	 */
+	std::string get_chunk_path(unsigned int x, unsigned int z) { return get_chunk_path(path, x, z); }
+
+	/*
+	 * Returns the path of a chunk's external (.mcc) file, alongside a given region file
+	 */
+	static std::string get_chunk_path(const std::string &path, unsigned int x, unsigned int z);
+
 	/*
 	 * Returns a region file's path
 	 */
@@ -125,6 +136,11 @@ public:
 	 */
 	static bool is_region_file(const std::string &path, int &x, int &z);
 
+	/*
+	 * Reads a chunk's compressed data from its external (.mcc) file
+	 */
+	void read_external(unsigned int x, unsigned int z, std::vector<char> &data);
+
 	/*
 	 * Sets a region file's path
 	 */
@@ -139,6 +155,11 @@ public:
 	 * Returns a string representation of a region file
 	 */
 	virtual std::string to_string(void);
+
+	/*
+	 * Writes a chunk's compressed data to its external (.mcc) file
+	 */
+	void write_external(unsigned int x, unsigned int z, const std::vector<char> &data);
 };
 
 #endif // REGION_FILE_H_
@@ -0,0 +1,254 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REGION_FILE_EDITOR_H_
+#define REGION_FILE_EDITOR_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "chunk_tag.h"
+#include "region_file.h"
+
+class region_file_editor : public region_file {
+public:
+
+	/*
+	 * Chunk write, for batched writes (removes the chunk if remove is set)
+	 */
+	typedef struct {
+		unsigned int x, z;
+		std::vector<char> data;
+		char type;
+		unsigned int modified;
+		bool remove;
+	} chunk_write;
+
+private:
+
+	/*
+	 * Region file
+	 */
+	std::fstream file;
+
+	/*
+	 * Sector at the end of a region file
+	 */
+	unsigned int end;
+
+	/*
+	 * Sector bitmap (set for header sectors and sectors held by chunks)
+	 */
+	std::vector<bool> used;
+
+	/*
+	 * Allocate a run of sectors for a chunk at a given index: in place if it still fits, otherwise the first free run,
+	 * otherwise at the end of the file (the chunk's old sectors stay held until it is moved)
+	 */
+	unsigned int allocate(unsigned int pos, unsigned int count);
+
+	/*
+	 * Find a free run of sectors: the first that fits, or the smallest that fits if best is set,
+	 * otherwise the free run at the end of the file
+	 */
+	unsigned int find_run(unsigned int count, bool best);
+
+	/*
+	 * Returns true if a chunk at a given index is stored in an external file
+	 */
+	bool is_external(unsigned int pos);
+
+	/*
+	 * Returns true if two paths name the same file
+	 */
+	static bool is_same_file(const std::string &left, const std::string &right);
+
+	/*
+	 * Mark a run of sectors as used or free
+	 */
+	void mark(unsigned int sector, unsigned int count, bool value);
+
+	/*
+	 * Form a chunk's sector-aligned record (length, compression type and data, padded to a whole sector),
+	 * returning its sector count
+	 */
+	static unsigned int form_record(const std::vector<char> &data, char type, std::vector<char> &record);
+
+	/*
+	 * Reads a chunk's record at a given index, as stored (external chunks are left as their stub)
+	 */
+	void read_record(unsigned int pos, std::vector<char> &data, char &type);
+
+	/*
+	 * Flush and sync a region file editor's file to disk
+	 */
+	void sync(void);
+
+	/*
+	 * Sync the directory holding a region file editor's file, making renames within it durable
+	 */
+	void sync_directory(void);
+
+	/*
+	 * Write a region file editor's header entries at a given index
+	 */
+	void write_header_at(unsigned int pos);
+
+	/*
+	 * Write data to a file descriptor at a given position, retrying short writes
+	 */
+	static void write_fully(int fd, const std::vector<char> &data, unsigned long long position);
+
+	/*
+	 * Write data to a new file at a given path, then sync it (the file is removed on failure)
+	 */
+	static void write_synced(const std::string &path, const std::vector<char> &data);
+
+public:
+
+	/*
+	 * Size of the runs written when compacting
+	 */
+	static const unsigned int WRITE_SIZE = 1048576;
+
+	/*
+	 * Region file editor constructor
+	 */
+	region_file_editor(void) : end(0) { return; }
+
+	/*
+	 * Region file editor constructor
+	 */
+	region_file_editor(const region_file_editor &other) : region_file(other.path, other.reg), end(other.end), used(other.used) { return; }
+
+	/*
+	 * Region file editor constructor
+	 */
+	explicit region_file_editor(const std::string &path) : region_file(path), end(0) { return; }
+
+	/*
+	 * Region file editor destructor
+	 */
+	virtual ~region_file_editor(void) { file.close(); }
+
+	/*
+	 * Region file editor assignment operator
+	 */
+	region_file_editor &operator=(const region_file_editor &other);
+
+	/*
+	 * Region file editor equals operator
+	 */
+	bool operator==(const region_file_editor &other);
+
+	/*
+	 * Region file editor not-equals operator
+	 */
+	bool operator!=(const region_file_editor &other) { return !(*this == other); }
+
+	/*
+	 * Closes a region file editor's file
+	 */
+	void close(void);
+
+	/*
+	 * Compact a region file editor's file in place, packing chunks tightly in sector order without re-encoding them,
+	 * returning the number of sectors reclaimed
+	 * (the compacted file is written and synced alongside, then renamed over the original)
+	 */
+	unsigned int compact(void);
+
+	/*
+	 * Write a compacted copy of a region file editor's file to a given path, returning the number of sectors reclaimed
+	 * (external chunk files are copied alongside the destination, which must not be the editor's own file)
+	 */
+	unsigned int compact(const std::string &destination);
+
+	/*
+	 * Copy a chunk's compressed data verbatim from a given source region file into a region file editor
+	 * (the chunk is only inflated and parsed if validate is set; copying a missing chunk removes the destination chunk)
+	 */
+	void copy_chunk(region_file_editor &source, unsigned int src_x, unsigned int src_z, unsigned int x, unsigned int z,
+			bool validate = false);
+
+	/*
+	 * Returns a region file editor's file
+	 */
+	std::fstream &get_file(void) { return file; }
+
+	/*
+	 * Returns a region file editor's free sector count (below the end of the file)
+	 */
+	unsigned int get_free_count(void);
+
+	/*
+	 * Returns a region file editor's sector count (including header sectors)
+	 */
+	unsigned int get_sector_count(void) { return end; }
+
+	/*
+	 * Returns true if a region file editor's file is open
+	 */
+	bool is_open(void) { return file.is_open(); }
+
+	/*
+	 * Opens a region file editor's file and reads its header, creating an empty region file if none exists
+	 * (header offsets are left as raw sector offset/count values)
+	 */
+	void open(void);
+
+	/*
+	 * Reads a chunk's compressed data and compression type, as stored
+	 * (data is empty if the chunk is missing, and read from its external file if the chunk is oversized)
+	 */
+	void read_chunk_data(unsigned int x, unsigned int z, std::vector<char> &data, char &type);
+
+	/*
+	 * Removes a chunk from a region file editor's header, freeing its sectors (and any external file)
+	 */
+	void remove_chunk(unsigned int x, unsigned int z);
+
+	/*
+	 * Returns a string representation of a region file editor
+	 */
+	std::string to_string(void) override;
+
+	/*
+	 * Compresses and writes a single chunk, then patches its header entries
+	 * (unmodified chunks holding their original data are written as read)
+	 */
+	void write_chunk(unsigned int x, unsigned int z, chunk_tag &tag, unsigned int modified);
+
+	/*
+	 * Writes a batch of chunks (at distinct coords), then publishes them with a single header write:
+	 * chunks are placed largest first into the smallest free runs that fit (never over sectors the batch replaces),
+	 * written in ascending sector order with adjacent chunks coalesced, and synced before the header is written and synced
+	 * (oversized chunks are staged in synced temporary files, renamed over their external files once the header is synced)
+	 */
+	void write_chunks(const std::vector<chunk_write> &writes);
+
+	/*
+	 * Writes a chunk's compressed data and compression type, as given, then patches its header entries
+	 * (the chunk is rewritten in place if it still fits, otherwise moved to the first free run of sectors or the end of the file;
+	 * oversized chunks are written to an external file, leaving a one-sector stub)
+	 */
+	void write_chunk_data(unsigned int x, unsigned int z, const std::vector<char> &data, char type, unsigned int modified);
+};
+
+#endif // REGION_FILE_EDITOR_H_
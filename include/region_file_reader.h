@@ -21,10 +21,20 @@
 #define REGION_FILE_READER_H_
 
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <stdexcept>
 #include <string>
+#include <vector>
+#include "bounding_box.h"
 #include "byte_stream.h"
+#include "chunk_section.h"
+#include "decode_context.h"
+#include "parallel.h"
 #include "region_file.h"
+#include "region_source.h"
 
 class region_file_reader : public region_file {
 private:
@@ -35,20 +45,52 @@ private:
 	std::ifstream file;
 
 	/*
-	 * Read a chunk tag from data
+	 * Names of the chunk-level tags to decode (all tags, if empty)
 	 */
-	void parse_chunk_tag(const std::vector<char> &data, chunk_tag &tag);
+	std::set<std::string> filter;
+
+	/*
+	 * Region file lock (serializes seeks and reads on the file)
+	 */
+	std::mutex lock;
+
+	/*
+	 * Keep each decoded chunk's original compressed data
+	 */
+	bool retain;
+
+	/*
+	 * Region source (read in place of the file when set; not owned)
+	 */
+	region_source *source;
+
+	/*
+	 * Decode contexts, one per parallel worker (created on first read, then kept so later reads reuse their buffers;
+	 * not copied)
+	 */
+	std::vector<std::unique_ptr<decode_context> > contexts;
+
+	/*
+	 * Read a chunk's biomes into a given buffer, returning false if none exist
+	 */
+	static bool get_chunk_biomes(const chunk_tag &tag, int (&biomes)[region_dim::BIOME_COUNT], bool &volume);
+
+	/*
+	 * Read a chunk tag from stream
+	 */
+	static void parse_chunk_tag(byte_stream &stream, const std::set<std::string> *filter, chunk_tag &tag);
 
 	/*
 	 * Read a tag from data
+	 * (returns NULL if the tag is excluded by the filter; tags are not filtered if filter is NULL)
 	 */
-	generic_tag *parse_tag(byte_stream &stream, bool is_list, char list_type);
+	static generic_tag *parse_tag(byte_stream &stream, bool is_list, char list_type, const std::set<std::string> *filter);
 
 	/*
 	 * Reads an array tag value from stream
 	 */
 	template <class T>
-	std::vector<T> read_array_value(byte_stream &stream) {
+	static std::vector<T> read_array_value(byte_stream &stream) {
 		int ele_len;
 		std::vector<T> value;
 
@@ -56,8 +98,11 @@ private:
 		if(!stream.good())
 			throw std::runtime_error("Unexpected end of stream");
 
-		// retrieve value
+		// retrieve value, sizing it up front when the stream holds enough data
 		ele_len = read_value<int>(stream);
+		if(ele_len > 0
+				&& (unsigned long long) ele_len * sizeof(T) <= stream.available())
+			value.reserve(ele_len);
 		for(int i = 0; i < ele_len; ++i)
 			value.push_back(read_value<T>(stream));
 		return value;
@@ -66,7 +111,13 @@ private:
 	/*
 	 * Reads chunk data from a file
 	 */
-	void read_chunks(void);
+	void read_chunks(parallel::POLICY policy);
+
+	/*
+	 * Read length bytes at a given offset from the file or source into a given buffer, returning false if they cannot
+	 * all be read (the caller holds the lock)
+	 */
+	bool read_at(unsigned long long offset, char *data, unsigned int length);
 
 	/*
 	 * Reads header data from a file
@@ -76,13 +127,13 @@ private:
 	/*
 	 * Reads a string tag value from stream
 	 */
-	std::string read_string_value(byte_stream &stream);
+	static std::string read_string_value(byte_stream &stream);
 
 	/*
 	 * Reads a numeric tag value from stream
 	 */
 	template <class T>
-	T read_value(byte_stream &stream) {
+	static T read_value(byte_stream &stream) {
 		T value;
 
 		// check stream status
@@ -94,22 +145,33 @@ private:
 		return value;
 	}
 
+	/*
+	 * Skip over a given number of bytes in stream
+	 */
+	static void skip_bytes(byte_stream &stream, long long length);
+
+	/*
+	 * Skip over a tag value of a given type in stream
+	 */
+	static void skip_tag(byte_stream &stream, char type);
+
 public:
 
 	/*
 	 * Region file reader constructor
 	 */
-	region_file_reader(void) { return; }
+	region_file_reader(void) : retain(false), source(NULL) { return; }
 
 	/*
 	 * Region file reader constructor
 	 */
-	explicit region_file_reader(const std::string &path) : region_file(path) { return; }
+	explicit region_file_reader(const std::string &path) : region_file(path), retain(false), source(NULL) { return; }
 
 	/*
 	 * Region file reader constructor
 	 */
-	region_file_reader(const region_file_reader &other) : region_file(other.path, other.reg) { return; }
+	region_file_reader(const region_file_reader &other) : region_file(other.path, other.reg), filter(other.filter),
+			retain(other.retain), source(NULL) { return; }
 
 	/*
 	 * Region file reader destructor
@@ -131,11 +193,91 @@ public:
 	 */
 	bool operator!=(const region_file_reader &other) { return !(*this == other); }
 
+	/*
+	 * Closes a region file reader's file (or releases its source)
+	 */
+	void close(void);
+
+	/*
+	 * Inflate and parse raw chunk data of a given compression type into a chunk tag
+	 * (decodes all tags if filter is NULL; safe to call concurrently)
+	 */
+	static void decode_chunk(std::vector<char> &data, char type, const std::set<std::string> *filter, chunk_tag &tag) {
+		decode_chunk(data, type, filter, tag, decode_context::get_local());
+	}
+
+	/*
+	 * Inflate and parse raw chunk data of a given compression type into a chunk tag, using a given decode context's buffers
+	 * (decodes all tags if filter is NULL; safe to call concurrently with distinct contexts)
+	 */
+	static void decode_chunk(std::vector<char> &data, char type, const std::set<std::string> *filter, chunk_tag &tag,
+			decode_context &context);
+
+	/*
+	 * Inflate and parse raw chunk data, as read by read_chunk_data, into a given chunk tag
+	 * (safe to call concurrently)
+	 */
+	void decode_chunk_data(unsigned int x, unsigned int z, std::vector<char> &data, chunk_tag &tag) {
+		decode_chunk_data(x, z, data, tag, decode_context::get_local());
+	}
+
+	/*
+	 * Inflate and parse raw chunk data, as read by read_chunk_data, into a given chunk tag, using a given decode context's
+	 * buffers (safe to call concurrently with distinct contexts)
+	 */
+	void decode_chunk_data(unsigned int x, unsigned int z, std::vector<char> &data, chunk_tag &tag, decode_context &context);
+
+	/*
+	 * Invoke a callback with the world coord and id of each non-air block within a region
+	 * (under the parallel policy, the callback may be called concurrently)
+	 */
+	template <class T>
+	void for_each_block(T func, parallel::POLICY policy = parallel::SEQUENTIAL) {
+		int reg_x = get_x_coord() * region_dim::CHUNK_WIDTH,
+				reg_z = get_z_coord() * region_dim::CHUNK_WIDTH;
+
+		// decode each section once, then walk it in storage order
+		for_each_section([&](unsigned int x, unsigned int z, chunk_section &section) {
+			unsigned int index = 0;
+			int ids[region_dim::SECTION_BLOCK_COUNT];
+			int w_x = (reg_x + (int) x) * (int) region_dim::BLOCK_WIDTH,
+					w_y = section.get_y() * (int) region_dim::SECTION_HEIGHT,
+					w_z = (reg_z + (int) z) * (int) region_dim::BLOCK_WIDTH;
+
+			section.get_blocks(ids);
+			for(int b_y = 0; b_y < (int) region_dim::SECTION_HEIGHT; ++b_y)
+				for(int b_z = 0; b_z < (int) region_dim::BLOCK_WIDTH; ++b_z)
+					for(int b_x = 0; b_x < (int) region_dim::BLOCK_WIDTH; ++b_x, ++index)
+						if(ids[index])
+							func(w_x + b_x, w_y + b_y, w_z + b_z, ids[index]);
+		}, policy);
+	}
+
+	/*
+	 * Invoke a callback with the chunk x, z coord of each non-empty section within a region,
+	 * skipping missing chunks, missing sections and all-air sections
+	 * (under the parallel policy, the callback may be called concurrently)
+	 */
+	void for_each_section(const std::function<void(unsigned int, unsigned int, chunk_section &)> &func,
+			parallel::POLICY policy = parallel::SEQUENTIAL);
+
 	/*
 	 * Returns a region biome value at a given x, z & b coord
 	 */
 	char get_biome_at(unsigned int x, unsigned int z, unsigned int b_x, unsigned int b_z);
 
+	/*
+	 * Fill a 512 x 512 raster, indexed by z * 512 + x in region block coords, with each chunk's biomes
+	 * (3D biomes are sampled at a given cell layer; missing chunks are filled with -1)
+	 */
+	void get_biome_raster(int *raster, unsigned int layer = 0, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Fill a 128 x 64 x 128 volume, indexed by (y * 128 + z) * 128 + x in region biome cells, with each chunk's biomes
+	 * (2D biomes are sampled at the center of each cell and repeated along y; missing chunks are filled with -1)
+	 */
+	void get_biome_volume(int *volume, parallel::POLICY policy = parallel::SEQUENTIAL);
+
 	/*
 	 * Returns a region's biomes at a given x, z coord
 	 */
@@ -151,6 +293,33 @@ public:
 	 */
 	std::vector<int> get_blocks_at(unsigned int x, unsigned int z);
 
+	/*
+	 * Fill the part of a dense array covering a world bounding box (see bounding_box::get_index) that lies
+	 * within a region with its block ids, decoding only the chunks and sections that intersect the box
+	 * (chunks not yet read are decoded on demand from an open file; missing chunks and sections are left untouched)
+	 */
+	void get_blocks_in(const bounding_box &box, int *blocks, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Fill a dense array covering a world bounding box (see bounding_box::get_index) with the block ids of the region files
+	 * in a given directory, opening only those regions that intersect the box
+	 * (missing regions, chunks and sections are filled with air)
+	 */
+	static void get_blocks_in(const std::string &directory, const bounding_box &box, std::vector<int> &blocks,
+			parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Read a chunk's height map ("HeightMap", or a named entry of "Heightmaps") into a given buffer,
+	 * returning false if none exist
+	 */
+	static bool get_chunk_heights(const chunk_tag &tag, const std::string &name, int (&heights)[region_dim::BLOCK_COUNT]);
+
+	/*
+	 * Returns the file, position and length of a chunk's compressed data (in the region file, or an external file),
+	 * returning false if the chunk is missing (throws for chunks held in a region source, which has no file)
+	 */
+	bool get_chunk_location(unsigned int x, unsigned int z, std::string &path, unsigned long long &offset, unsigned int &length);
+
 	/*
 	 * Returns a region's chunk tag at a given x, z coord
 	 */
@@ -171,6 +340,17 @@ public:
 	 */
 	std::ifstream &get_file(void) { return file; }
 
+	/*
+	 * Returns a region file reader's tag filter
+	 */
+	const std::set<std::string> &get_filter(void) { return filter; }
+
+	/*
+	 * Fill a 512 x 512 raster, indexed by z * 512 + x in region block coords, with each chunk's height map
+	 * ("HeightMap", or a named entry of "Heightmaps" such as "WORLD_SURFACE"; missing chunks are filled with 0)
+	 */
+	void get_heightmap_raster(int *raster, const std::string &name = "HeightMap", parallel::POLICY policy = parallel::SEQUENTIAL);
+
 	/*
 	 * Return a region's x coordinate
 	 */
@@ -187,9 +367,85 @@ public:
 	bool is_filled(unsigned int x, unsigned int z);
 
 	/*
-	 * Reads a file into region_file
+	 * Returns a region file reader's open status
+	 */
+	bool is_open(void) { return file.is_open() || source; }
+
+	/*
+	 * Returns true if a region file reader keeps each decoded chunk's original compressed data
+	 */
+	bool is_retaining(void) { return retain; }
+
+	/*
+	 * Opens a region file reader's file and reads its header, leaving the chunks to be read on demand
+	 */
+	void open(void);
+
+	/*
+	 * Opens a region source for a region at a given x, z coord and reads its header, leaving the chunks to be read on demand
+	 * (the source is read in place of the file until closed, and must outlive that; external chunks are still read
+	 * alongside the reader's path)
+	 */
+	void open(region_source &source, int x, int z);
+
+	/*
+	 * Reads a file into region_file, replacing any chunks previously read
+	 * (under the parallel policy, chunks are inflated and parsed concurrently)
+	 */
+	void read(parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Reads a region source for a region at a given x, z coord into region_file, replacing any chunks previously read
+	 * (under the parallel policy, chunks are inflated and parsed concurrently)
+	 */
+	void read(region_source &source, int x, int z, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Reads a single chunk at a given x, z coord from an open file into the region
+	 */
+	void read_chunk(unsigned int x, unsigned int z);
+
+	/*
+	 * Reads a single chunk at a given x, z coord from an open file into a given chunk tag
+	 * (safe to call concurrently)
+	 */
+	void read_chunk(unsigned int x, unsigned int z, chunk_tag &tag) { read_chunk(x, z, tag, decode_context::get_local()); }
+
+	/*
+	 * Reads a single chunk at a given x, z coord from an open file into a given chunk tag, using a given decode context's
+	 * buffers (safe to call concurrently with distinct contexts)
+	 */
+	void read_chunk(unsigned int x, unsigned int z, chunk_tag &tag, decode_context &context);
+
+	/*
+	 * Closes a region file reader's file and opens another, clearing the region read from the previous file
+	 * while keeping the storage held by its chunk tags for reuse (filter and retain settings are kept)
+	 */
+	void reopen(const std::string &path);
+
+	/*
+	 * Closes a region file reader's file and opens a region source for a region at a given x, z coord, clearing the region
+	 * read previously while keeping the storage held by its chunk tags for reuse
+	 */
+	void reopen(region_source &source, int x, int z);
+
+	/*
+	 * Reads the raw (compressed) data of a single chunk at a given x, z coord from an open file
+	 * (safe to call concurrently; the data is empty for missing chunks, and read from external files for oversized chunks)
+	 */
+	void read_chunk_data(unsigned int x, unsigned int z, std::vector<char> &data);
+
+	/*
+	 * Sets a region file reader's tag filter, limiting which chunk-level tags are decoded by read
+	 * (for example "HeightMap" and "Biomes"; "Level" itself is always decoded)
+	 */
+	void set_filter(const std::set<std::string> &filter) { this->filter = filter; }
+
+	/*
+	 * Sets whether a region file reader keeps each decoded chunk's original compressed data,
+	 * so unmodified chunks can be written back without being re-encoded
 	 */
-	void read(void);
+	void set_retain(bool retain) { this->retain = retain; }
 
 	/*
 	 * Returns a string representation of a region file reader
@@ -0,0 +1,149 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REGION_FILE_TRANSACTION_H_
+#define REGION_FILE_TRANSACTION_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "chunk_tag.h"
+#include "compression_policy.h"
+#include "parallel.h"
+#include "region_file_editor.h"
+
+class region_file_transaction {
+public:
+
+	/*
+	 * Update operations
+	 */
+	enum OPERATION { REPLACE = 0, RAW, REMOVE };
+
+private:
+
+	/*
+	 * Chunk update (a chunk tag to encode, or compressed data as given)
+	 */
+	typedef struct {
+		OPERATION operation;
+		chunk_tag *tag;
+		std::vector<char> data;
+		char type;
+		unsigned int modified;
+	} update;
+
+	/*
+	 * Transaction region file editor
+	 */
+	region_file_editor &editor;
+
+	/*
+	 * Pending updates, by chunk index (later updates to a chunk replace earlier ones)
+	 */
+	std::map<unsigned int, update> updates;
+
+	/*
+	 * Queue an update at a given x, z coord
+	 */
+	void add(unsigned int x, unsigned int z, const update &value);
+
+	/*
+	 * Region file transaction constructor (not copyable)
+	 */
+	region_file_transaction(const region_file_transaction &other);
+
+	/*
+	 * Region file transaction assignment operator (not copyable)
+	 */
+	region_file_transaction &operator=(const region_file_transaction &other);
+
+public:
+
+	/*
+	 * Region file transaction constructor
+	 */
+	explicit region_file_transaction(region_file_editor &editor) : editor(editor) { return; }
+
+	/*
+	 * Region file transaction destructor
+	 * (pending updates are discarded)
+	 */
+	virtual ~region_file_transaction(void) { return; }
+
+	/*
+	 * Region file transaction equals operator
+	 */
+	bool operator==(const region_file_transaction &other) { return this == &other; }
+
+	/*
+	 * Region file transaction not-equals operator
+	 */
+	bool operator!=(const region_file_transaction &other) { return !(*this == other); }
+
+	/*
+	 * Discard a region file transaction's pending updates
+	 */
+	void clear(void) { updates.clear(); }
+
+	/*
+	 * Commit a region file transaction's pending updates: chunk tags are encoded (under the parallel policy, concurrently),
+	 * then every update is written and published with a single header write (see region_file_editor::write_chunks)
+	 */
+	void commit(parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Commit a region file transaction's pending updates, deflating chunk tags under a compression policy
+	 */
+	void commit(compression_policy &encoding, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Queue a verbatim copy of a chunk's compressed data from a given source region file
+	 * (the data is read now; copying a missing chunk removes the destination chunk)
+	 */
+	void copy_chunk(region_file_editor &source, unsigned int src_x, unsigned int src_z, unsigned int x, unsigned int z);
+
+	/*
+	 * Queue the removal of a chunk
+	 */
+	void remove_chunk(unsigned int x, unsigned int z);
+
+	/*
+	 * Returns a region file transaction's pending update count
+	 */
+	unsigned int size(void) { return updates.size(); }
+
+	/*
+	 * Returns a string representation of a region file transaction
+	 */
+	std::string to_string(void);
+
+	/*
+	 * Queue a chunk tag to be encoded and written on commit
+	 * (the tag is referenced, not copied, so it must outlive the commit)
+	 */
+	void write_chunk(unsigned int x, unsigned int z, chunk_tag &tag, unsigned int modified);
+
+	/*
+	 * Queue a chunk's compressed data and compression type to be written as given
+	 */
+	void write_chunk_data(unsigned int x, unsigned int z, const std::vector<char> &data, char type, unsigned int modified);
+};
+
+#endif // REGION_FILE_TRANSACTION_H_
@@ -22,6 +22,7 @@
 
 #include <fstream>
 #include <string>
+#include "compression_policy.h"
 #include "region_file.h"
 
 class region_file_writer : public region_file {
@@ -86,8 +87,14 @@ public:
 
 	/*
 	 * Write a region file to file
+	 * (unmodified chunks holding their original data are written as read, without being re-encoded)
 	 */
 	void write(void);
+
+	/*
+	 * Write a region file to file, deflating modified chunks under a compression policy
+	 */
+	void write(compression_policy &policy);
 };
 
 #endif // REGION_FILE_WRITER_H_
@@ -101,6 +101,12 @@ public:
 	 */
 	void set_info(const chunk_info (&info)[region_dim::CHUNK_COUNT]);
 
+	/*
+	 * Set a region header's info from the raw location and timestamp tables at the start of a region file
+	 * (each info's offset is left as stored, (sector offset << 8) | sector count, and its length as 0)
+	 */
+	void set_data(const std::vector<char> &data);
+
 	/*
 	 * Set a region header's info at a given index
 	 */
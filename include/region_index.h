@@ -0,0 +1,182 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REGION_INDEX_H_
+#define REGION_INDEX_H_
+
+#include <string>
+#include "chunk_tag.h"
+#include "parallel.h"
+#include "region_dim.h"
+#include "region_file_reader.h"
+
+class region_index {
+public:
+
+	/*
+	 * Number of 64-bit words in each chunk's tag name bloom filter
+	 */
+	static const unsigned int BLOOM_WORDS = 4;
+
+	/*
+	 * Index file magic and version
+	 */
+	static const unsigned int MAGIC = 0x4c414958;
+	static const unsigned int VERSION = 2;
+
+	/*
+	 * Index file extension (appended to the region file path)
+	 */
+	static const std::string EXTENSION;
+
+	/*
+	 * Per-chunk index entry
+	 */
+	struct entry {
+
+		/*
+		 * Chunk header offset and timestamp the entry was built from (0 offset for missing chunks)
+		 */
+		unsigned int offset, modified;
+
+		/*
+		 * Uncompressed chunk size (in bytes)
+		 */
+		unsigned int size;
+
+		/*
+		 * Section presence, with bit (y + 32) set for each section holding block data
+		 */
+		unsigned long long sections;
+
+		/*
+		 * Lowest and highest height map values (0 if the chunk has no height map)
+		 */
+		int min_height, max_height;
+
+		/*
+		 * Number of entities and tile entities
+		 */
+		unsigned int entities, tile_entities;
+
+		/*
+		 * Bloom filter over the names of every tag in the chunk
+		 */
+		unsigned long long names[BLOOM_WORDS];
+	};
+
+private:
+
+	/*
+	 * Index entries, by chunk index
+	 */
+	entry entries[region_dim::CHUNK_COUNT];
+
+	/*
+	 * Add the names of a tag and its sub-tags to a bloom filter (recursively)
+	 */
+	static void add_names(const generic_tag *tag, unsigned long long (&names)[BLOOM_WORDS]);
+
+	/*
+	 * Build an entry from a decoded chunk and its uncompressed size
+	 */
+	static void build_entry(const chunk_tag &tag, unsigned int size, entry &value);
+
+	/*
+	 * Returns the bloom filter bit positions of a tag name
+	 */
+	static void get_bits(const std::string &name, unsigned int (&bits)[3]);
+
+public:
+
+	/*
+	 * Region index constructor
+	 */
+	region_index(void);
+
+	/*
+	 * Region index constructor
+	 */
+	region_index(const region_index &other);
+
+	/*
+	 * Region index destructor
+	 */
+	virtual ~region_index(void) { return; }
+
+	/*
+	 * Region index assignment operator
+	 */
+	region_index &operator=(const region_index &other);
+
+	/*
+	 * Region index equals operator
+	 */
+	bool operator==(const region_index &other);
+
+	/*
+	 * Region index not-equals operator
+	 */
+	bool operator!=(const region_index &other) { return !(*this == other); }
+
+	/*
+	 * Returns a region index's entry at a given chunk index
+	 */
+	const entry &get_entry_at(unsigned int index);
+
+	/*
+	 * Returns true if an entry still matches a region header's info at a given chunk index
+	 */
+	bool is_current(region_header &header, unsigned int index);
+
+	/*
+	 * Load a region index from file
+	 */
+	void load(const std::string &path);
+
+	/*
+	 * Returns false if a chunk at a given chunk index definitely holds no tag of a given name
+	 */
+	bool might_contain(unsigned int index, const std::string &name);
+
+	/*
+	 * Load a region's sidecar index (the region path plus EXTENSION), rebuilding stale entries from an open,
+	 * unfiltered reader and saving the sidecar if any were rebuilt, returning the number of rebuilt entries
+	 * (a missing or malformed sidecar is rebuilt in full)
+	 */
+	unsigned int open(region_file_reader &reader, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Rebuild the entries that no longer match an open, unfiltered reader's header, returning their number
+	 * (under the parallel policy, chunks are decoded concurrently)
+	 */
+	unsigned int refresh(region_file_reader &reader, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Save a region index to file
+	 */
+	void save(const std::string &path);
+
+	/*
+	 * Returns a string representation of a region index
+	 */
+	std::string to_string(void);
+};
+
+#endif // REGION_INDEX_H_
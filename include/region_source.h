@@ -0,0 +1,133 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REGION_SOURCE_H_
+#define REGION_SOURCE_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class region_source {
+public:
+
+	/*
+	 * Source types
+	 */
+	enum TYPE { MEMORY = 0, DESCRIPTOR, CALLBACK };
+
+	/*
+	 * Source callback (fills a given buffer with length bytes from offset, returning false on failure)
+	 */
+	typedef std::function<bool(unsigned long long, char *, unsigned int)> callback;
+
+private:
+
+	/*
+	 * Source type
+	 */
+	TYPE type;
+
+	/*
+	 * Source memory buffer and length (not owned)
+	 */
+	const char *data;
+	unsigned long long length;
+
+	/*
+	 * Source file descriptor (not owned)
+	 */
+	int descriptor;
+
+	/*
+	 * Source callback
+	 */
+	callback func;
+
+public:
+
+	/*
+	 * Region source constructor
+	 * (reads from a memory buffer, which must outlive the source)
+	 */
+	region_source(const char *data, unsigned long long length) : type(MEMORY), data(data), length(length), descriptor(-1) { return; }
+
+	/*
+	 * Region source constructor
+	 * (reads from a memory buffer, which must outlive the source and not be resized)
+	 */
+	explicit region_source(const std::vector<char> &data) : type(MEMORY), data(data.data()), length(data.size()),
+			descriptor(-1) { return; }
+
+	/*
+	 * Region source constructor
+	 * (reads from an open file descriptor by position, which must outlive the source)
+	 */
+	explicit region_source(int descriptor) : type(DESCRIPTOR), data(NULL), length(0), descriptor(descriptor) { return; }
+
+	/*
+	 * Region source constructor
+	 * (reads through a callback, which is called under the reader's lock)
+	 */
+	explicit region_source(const callback &func) : type(CALLBACK), data(NULL), length(0), descriptor(-1), func(func) { return; }
+
+	/*
+	 * Region source constructor
+	 */
+	region_source(const region_source &other) : type(other.type), data(other.data), length(other.length),
+			descriptor(other.descriptor), func(other.func) { return; }
+
+	/*
+	 * Region source destructor
+	 */
+	virtual ~region_source(void) { return; }
+
+	/*
+	 * Region source assignment operator
+	 */
+	region_source &operator=(const region_source &other);
+
+	/*
+	 * Region source equals operator
+	 * (callback sources are only equal to themselves)
+	 */
+	bool operator==(const region_source &other);
+
+	/*
+	 * Region source not-equals operator
+	 */
+	bool operator!=(const region_source &other) { return !(*this == other); }
+
+	/*
+	 * Returns a region source's type
+	 */
+	TYPE get_type(void) { return type; }
+
+	/*
+	 * Read length bytes at a given offset from a region source into a given buffer, returning false if they cannot all be read
+	 */
+	bool read(unsigned long long offset, char *data, unsigned int length);
+
+	/*
+	 * Returns a string representation of a region source
+	 */
+	std::string to_string(void);
+};
+
+#endif // REGION_SOURCE_H_
@@ -87,7 +87,7 @@ public:
 	/*
 	 * Return a byte tag's value
 	 */
-	char get_value(void) { return value; }
+	char get_value(void) const { return value; }
 
 	/*
 	 * Set a byte tag's value
@@ -72,18 +72,23 @@ public:
 	/*
 	 * Returns a compound tag tag at a given index
 	 */
-	generic_tag *at(unsigned int index) { return value.at(index); }
+	generic_tag *at(unsigned int index) const { return value.at(index); }
 
 	/*
 	 * Returns a compound tag's empty status
 	 */
-	bool empty(void) { return value.empty(); }
+	bool empty(void) const { return value.empty(); }
 
 	/*
 	 * Erase a tag in a compound tag at a given index
 	 */
 	void erase(unsigned int index) { value.erase(value.begin() + index); }
 
+	/*
+	 * Returns a compound tag's direct sub-tag with a given name, or NULL if none exists
+	 */
+	generic_tag *find(const std::string &name) const;
+
 	/*
 	 * Return a compound tag's data
 	 */
@@ -112,7 +117,7 @@ public:
 	/*
 	 * Returns a compound tag value's size
 	 */
-	unsigned int size(void) { return value.size(); }
+	unsigned int size(void) const { return value.size(); }
 
 	/*
 	 * Return a string representation of a compound tag
@@ -97,12 +97,12 @@ public:
 	/*
 	 * Return a generic tag's name
 	 */
-	std::string get_name(void) { return name; }
+	std::string get_name(void) const { return name; }
 
 	/*
 	 * Return a generic tag's type
 	 */
-	unsigned char get_type(void) { return type; }
+	unsigned char get_type(void) const { return type; }
 
 	/*
 	 * Set a generic tag's name
@@ -87,7 +87,7 @@ public:
 	/*
 	 * Return a integer tag's value
 	 */
-	int get_value(void) { return value; }
+	int get_value(void) const { return value; }
 
 	/*
 	 * Set a integer tag's value
@@ -82,12 +82,12 @@ public:
 	/*
 	 * Returns a list tag tag at a given index
 	 */
-	generic_tag *at(unsigned int index) { return value.at(index); }
+	generic_tag *at(unsigned int index) const { return value.at(index); }
 
 	/*
 	 * Returns a list tag's empty status
 	 */
-	bool empty(void) { return value.empty(); }
+	bool empty(void) const { return value.empty(); }
 
 	/*
 	 * Erase a tag in a list tag at a given index
@@ -102,7 +102,7 @@ public:
 	/*
 	 * Returns a list tag's element type
 	 */
-	char get_element_type(void) { return ele_type; }
+	char get_element_type(void) const { return ele_type; }
 
 	/*
 	 * Return a list tag's value
@@ -127,7 +127,7 @@ public:
 	/*
 	 * Returns a list tag value's size
 	 */
-	unsigned int size(void) { return value.size(); }
+	unsigned int size(void) const { return value.size(); }
 
 	/*
 	 * Return a string representation of a list tag
@@ -0,0 +1,193 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class thread_pool {
+public:
+
+	/*
+	 * Pool task, called with the index of the worker running it
+	 */
+	typedef std::function<void(unsigned int)> task;
+
+private:
+
+	/*
+	 * Per-worker task queue (the owner works from the back, thieves steal from the front)
+	 */
+	struct queue {
+
+		/*
+		 * Queue lock
+		 */
+		std::mutex lock;
+
+		/*
+		 * Queued tasks
+		 */
+		std::deque<task> tasks;
+	};
+
+	/*
+	 * First task failure
+	 */
+	std::exception_ptr error;
+
+	/*
+	 * Task failure status
+	 */
+	std::atomic<bool> failed;
+
+	/*
+	 * Pool lock (guards sleeping, waking and failures)
+	 */
+	std::mutex lock;
+
+	/*
+	 * Next queue to submit external tasks to
+	 */
+	std::atomic<unsigned int> next;
+
+	/*
+	 * Number of tasks submitted but not yet finished, and number of tasks queued but not yet started
+	 */
+	std::atomic<unsigned int> pending, queued;
+
+	/*
+	 * Per-worker task queues
+	 */
+	std::vector<std::unique_ptr<queue>> queues;
+
+	/*
+	 * Signalled when tasks are queued, and when all tasks finish
+	 */
+	std::condition_variable ready, idle;
+
+	/*
+	 * Pool stopping status
+	 */
+	bool stopping;
+
+	/*
+	 * Pool worker threads
+	 */
+	std::vector<std::thread> workers;
+
+	/*
+	 * Push a task onto a given worker's queue
+	 */
+	void push(unsigned int worker, const task &func);
+
+	/*
+	 * Run a worker's loop
+	 */
+	void run(unsigned int worker);
+
+	/*
+	 * Start a given number of workers
+	 */
+	void start(unsigned int count);
+
+	/*
+	 * Stop and join all workers
+	 */
+	void stop(void);
+
+	/*
+	 * Take a task, from the back of a worker's own queue or else from the front of another's,
+	 * returning false if every queue is empty
+	 */
+	bool take(unsigned int worker, task &func);
+
+public:
+
+	/*
+	 * Thread pool constructor
+	 * (a count of 0 uses one worker per hardware thread)
+	 */
+	explicit thread_pool(unsigned int count = 0);
+
+	/*
+	 * Thread pool constructor
+	 * (starts a new pool with the same number of workers)
+	 */
+	thread_pool(const thread_pool &other);
+
+	/*
+	 * Thread pool destructor
+	 */
+	virtual ~thread_pool(void) { stop(); }
+
+	/*
+	 * Thread pool assignment operator
+	 * (restarts the pool with the same number of workers as the other)
+	 */
+	thread_pool &operator=(const thread_pool &other);
+
+	/*
+	 * Thread pool equals operator
+	 */
+	bool operator==(const thread_pool &other);
+
+	/*
+	 * Thread pool not-equals operator
+	 */
+	bool operator!=(const thread_pool &other) { return !(*this == other); }
+
+	/*
+	 * Returns a pool's worker count
+	 */
+	unsigned int get_thread_count(void) const { return queues.size(); }
+
+	/*
+	 * Submit a task from outside of the pool
+	 */
+	void submit(const task &func) { push(next++ % queues.size(), func); }
+
+	/*
+	 * Submit a task from within a task running on a given worker, queueing it locally
+	 */
+	void submit(unsigned int worker, const task &func) { push(worker, func); }
+
+	/*
+	 * Returns a string representation of a thread pool
+	 */
+	std::string to_string(void);
+
+	/*
+	 * Wait until every submitted task (including tasks they submit) has finished, rethrowing the first failure
+	 * (once a task fails, tasks not yet started are dropped)
+	 */
+	void wait(void);
+};
+
+#endif // THREAD_POOL_H_
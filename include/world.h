@@ -0,0 +1,223 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORLD_H_
+#define WORLD_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bounding_box.h"
+#include "chunk_tag.h"
+#include "parallel.h"
+#include "region_file_reader.h"
+
+class world {
+public:
+
+	/*
+	 * Region coord (x, z)
+	 */
+	typedef std::pair<int, int> coord;
+
+	/*
+	 * Default number of open region file readers
+	 */
+	static const unsigned int DEFAULT_CAPACITY = 16;
+
+private:
+
+	/*
+	 * Open region file readers, most recently used first
+	 */
+	typedef std::list<std::pair<coord, std::shared_ptr<region_file_reader>>> reader_list;
+
+	/*
+	 * Max number of open region file readers
+	 */
+	unsigned int capacity;
+
+	/*
+	 * Region directory
+	 */
+	std::string directory;
+
+	/*
+	 * Names of the chunk-level tags decoded by opened readers (all tags, if empty)
+	 */
+	std::set<std::string> filter;
+
+	/*
+	 * Reader lock (guards the open reader list)
+	 */
+	std::mutex lock;
+
+	/*
+	 * Open region file readers
+	 */
+	reader_list readers;
+
+	/*
+	 * Open region file reader positions, by region coord
+	 */
+	std::map<coord, reader_list::iterator> reader_index;
+
+	/*
+	 * Region file paths, by region coord
+	 */
+	std::map<coord, std::string> regions;
+
+	/*
+	 * Evict the least recently used readers beyond capacity (lock must be held)
+	 */
+	void evict(void);
+
+public:
+
+	/*
+	 * World constructor
+	 */
+	world(void) : capacity(DEFAULT_CAPACITY) { return; }
+
+	/*
+	 * World constructor
+	 * (open readers are not shared with the copy)
+	 */
+	world(const world &other) : capacity(other.capacity), directory(other.directory), filter(other.filter), regions(other.regions) {
+		return;
+	}
+
+	/*
+	 * World constructor
+	 */
+	explicit world(const std::string &directory, unsigned int capacity = DEFAULT_CAPACITY);
+
+	/*
+	 * World destructor
+	 */
+	virtual ~world(void) { return; }
+
+	/*
+	 * World assignment operator
+	 */
+	world &operator=(const world &other);
+
+	/*
+	 * World equals operator
+	 */
+	bool operator==(const world &other);
+
+	/*
+	 * World not-equals operator
+	 */
+	bool operator!=(const world &other) { return !(*this == other); }
+
+	/*
+	 * Close all of a world's open region file readers
+	 * (readers still held by callers stay open until released)
+	 */
+	void close(void);
+
+	/*
+	 * Returns a world block id at a given world coord (missing regions, chunks and sections are air)
+	 */
+	int get_block_at(int x, int y, int z);
+
+	/*
+	 * Fill a dense array covering a world bounding box (see bounding_box::get_index) with block ids,
+	 * opening only those regions that intersect the box (missing regions, chunks and sections are filled with air)
+	 */
+	void get_blocks_in(const bounding_box &box, std::vector<int> &blocks, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Returns a world's max number of open region file readers
+	 */
+	unsigned int get_capacity(void) { return capacity; }
+
+	/*
+	 * Map a world chunk coord to its region coord and chunk x, z coord within the region
+	 */
+	static void get_chunk_coord(int c_x, int c_z, coord &reg, unsigned int &x, unsigned int &z);
+
+	/*
+	 * Returns a world's region directory
+	 */
+	const std::string &get_directory(void) { return directory; }
+
+	/*
+	 * Returns a world's tag filter
+	 */
+	const std::set<std::string> &get_filter(void) { return filter; }
+
+	/*
+	 * Returns an open region file reader (header only, chunks read on demand) for a given region coord,
+	 * or NULL if the region does not exist
+	 */
+	std::shared_ptr<region_file_reader> get_reader(const coord &reg);
+
+	/*
+	 * Returns the region coord containing a given world block coord
+	 */
+	static coord get_region_coord(int x, int z) { return coord(x >> 9, z >> 9); }
+
+	/*
+	 * Returns a world's region file paths, by region coord
+	 */
+	const std::map<coord, std::string> &get_regions(void) { return regions; }
+
+	/*
+	 * Returns true if a world contains a region at a given region coord
+	 */
+	bool has_region(const coord &reg) { return regions.find(reg) != regions.end(); }
+
+	/*
+	 * Reads a single chunk at a given world chunk coord into a given chunk tag, returning false if the chunk does not exist
+	 * (safe to call concurrently)
+	 */
+	bool read_chunk(int c_x, int c_z, chunk_tag &tag);
+
+	/*
+	 * Scan a world's region directory, indexing its region files by coord
+	 * (closes all open region file readers)
+	 */
+	void scan(void);
+
+	/*
+	 * Sets a world's max number of open region file readers
+	 */
+	void set_capacity(unsigned int capacity);
+
+	/*
+	 * Sets a world's tag filter, limiting which chunk-level tags are decoded by its readers
+	 * (see region_file_reader::set_filter; closes all open region file readers)
+	 */
+	void set_filter(const std::set<std::string> &filter);
+
+	/*
+	 * Returns a string representation of a world
+	 */
+	std::string to_string(void);
+};
+
+#endif // WORLD_H_
@@ -0,0 +1,166 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORLD_CENSUS_H_
+#define WORLD_CENSUS_H_
+
+#include <string>
+#include <vector>
+#include "parallel.h"
+#include "region_header.h"
+#include "world.h"
+
+class world_census {
+public:
+
+	/*
+	 * Per-region census
+	 */
+	struct region_count {
+
+		/*
+		 * Region coord
+		 */
+		world::coord coord;
+
+		/*
+		 * Number of chunks, and number of chunks located outside of the file (or with a malformed prefix, or a missing
+		 * external file)
+		 */
+		unsigned int chunks, invalid;
+
+		/*
+		 * Compressed chunk data size (in bytes; the allocated sector size unless chunk prefixes were read, which also
+		 * counts external chunks at their .mcc file size)
+		 */
+		unsigned long long compressed_size;
+
+		/*
+		 * Sectors allocated to the header and chunks, and sectors in the file
+		 */
+		unsigned long long sectors, file_sectors;
+
+		/*
+		 * Oldest and newest chunk timestamps (0 if the region has no chunks)
+		 */
+		unsigned int min_modified, max_modified;
+	};
+
+private:
+
+	/*
+	 * Region censuses, in region coord order
+	 */
+	std::vector<region_count> regions;
+
+	/*
+	 * Count a single region file, from its header and, optionally, its chunk prefixes
+	 */
+	static void count_region(const std::string &path, bool prefixes, region_count &count);
+
+public:
+
+	/*
+	 * World census constructor
+	 */
+	world_census(void) { return; }
+
+	/*
+	 * World census constructor
+	 */
+	world_census(const world_census &other) : regions(other.regions) { return; }
+
+	/*
+	 * World census destructor
+	 */
+	virtual ~world_census(void) { return; }
+
+	/*
+	 * World census assignment operator
+	 */
+	world_census &operator=(const world_census &other);
+
+	/*
+	 * World census equals operator
+	 */
+	bool operator==(const world_census &other);
+
+	/*
+	 * World census not-equals operator
+	 */
+	bool operator!=(const world_census &other) { return !(*this == other); }
+
+	/*
+	 * Returns a census's total chunk count
+	 */
+	unsigned long long get_chunk_count(void);
+
+	/*
+	 * Returns a census's total compressed chunk data size (in bytes)
+	 */
+	unsigned long long get_compressed_size(void);
+
+	/*
+	 * Returns a census's total sector count (in the files)
+	 */
+	unsigned long long get_file_sector_count(void);
+
+	/*
+	 * Returns a census's total invalid chunk count
+	 */
+	unsigned long long get_invalid_count(void);
+
+	/*
+	 * Returns a census's newest chunk timestamp
+	 */
+	unsigned int get_max_modified(void);
+
+	/*
+	 * Returns a census's oldest chunk timestamp
+	 */
+	unsigned int get_min_modified(void);
+
+	/*
+	 * Returns a census's region censuses
+	 */
+	const std::vector<region_count> &get_regions(void) { return regions; }
+
+	/*
+	 * Returns a census's total allocated sector count
+	 */
+	unsigned long long get_sector_count(void);
+
+	/*
+	 * Returns a census's sector utilization (allocated sectors over file sectors)
+	 */
+	double get_utilization(void);
+
+	/*
+	 * Take a census of every region in a world, reading only region headers and, optionally, the 5-byte prefix of each chunk
+	 * (nothing is inflated; under the parallel policy, regions are counted concurrently)
+	 */
+	void take(world &wld, bool prefixes = false, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Returns a string representation of a world census
+	 */
+	std::string to_string(void);
+};
+
+#endif // WORLD_CENSUS_H_
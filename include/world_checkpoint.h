@@ -0,0 +1,122 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORLD_CHECKPOINT_H_
+#define WORLD_CHECKPOINT_H_
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "chunk_tag.h"
+#include "parallel.h"
+#include "region_header.h"
+#include "world.h"
+
+class world_checkpoint {
+private:
+
+	/*
+	 * Chunk timestamps, indexed by chunk index, by region coord (0 for missing chunks)
+	 */
+	std::map<world::coord, std::vector<unsigned int>> timestamps;
+
+public:
+
+	/*
+	 * Checkpoint file magic and version
+	 */
+	static const unsigned int MAGIC = 0x4c414350;
+	static const unsigned int VERSION = 1;
+
+	/*
+	 * World checkpoint constructor
+	 */
+	world_checkpoint(void) { return; }
+
+	/*
+	 * World checkpoint constructor
+	 */
+	world_checkpoint(const world_checkpoint &other) : timestamps(other.timestamps) { return; }
+
+	/*
+	 * World checkpoint destructor
+	 */
+	virtual ~world_checkpoint(void) { return; }
+
+	/*
+	 * World checkpoint assignment operator
+	 */
+	world_checkpoint &operator=(const world_checkpoint &other);
+
+	/*
+	 * World checkpoint equals operator
+	 */
+	bool operator==(const world_checkpoint &other);
+
+	/*
+	 * World checkpoint not-equals operator
+	 */
+	bool operator!=(const world_checkpoint &other) { return !(*this == other); }
+
+	/*
+	 * Remove all of a checkpoint's timestamps
+	 */
+	void clear(void) { timestamps.clear(); }
+
+	/*
+	 * Returns a checkpoint's timestamp of a chunk at a given region coord and chunk index (0 if not recorded)
+	 */
+	unsigned int get_modified(const world::coord &reg, unsigned int index) const;
+
+	/*
+	 * Returns a checkpoint's region count
+	 */
+	unsigned int get_region_count(void) { return timestamps.size(); }
+
+	/*
+	 * Load a checkpoint from file
+	 */
+	void load(const std::string &path);
+
+	/*
+	 * Decode and visit every chunk of a world whose header timestamp differs from a previous checkpoint
+	 * (including new chunks), filling a new checkpoint from the headers, and returning the number of chunks visited
+	 * (only region headers are read for unchanged regions; under the parallel policy, the visitor is called concurrently)
+	 */
+	static unsigned int read_changed(world &wld, const world_checkpoint &previous, world_checkpoint &current,
+			const std::function<void(int, int, chunk_tag &)> &func, parallel::POLICY policy = parallel::SEQUENTIAL);
+
+	/*
+	 * Save a checkpoint to file
+	 */
+	void save(const std::string &path);
+
+	/*
+	 * Record a region header's chunk timestamps at a given region coord
+	 */
+	void set_region(const world::coord &reg, region_header &header);
+
+	/*
+	 * Returns a string representation of a world checkpoint
+	 */
+	std::string to_string(void);
+};
+
+#endif // WORLD_CHECKPOINT_H_
@@ -0,0 +1,128 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORLD_SCANNER_H_
+#define WORLD_SCANNER_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "chunk_tag.h"
+#include "thread_pool.h"
+#include "world.h"
+
+class world_scanner {
+public:
+
+	/*
+	 * Chunk visitor, called with the index of the worker running it and a chunk's world chunk coord
+	 */
+	typedef std::function<void(unsigned int, int, int, chunk_tag &)> visitor;
+
+private:
+
+	/*
+	 * Scanner thread pool
+	 */
+	thread_pool pool;
+
+	/*
+	 * Scanner world
+	 */
+	world *wld;
+
+public:
+
+	/*
+	 * World scanner constructor
+	 */
+	world_scanner(void) : wld(NULL) { return; }
+
+	/*
+	 * World scanner constructor
+	 * (starts a new pool with the same number of workers)
+	 */
+	world_scanner(const world_scanner &other) : pool(other.pool), wld(other.wld) { return; }
+
+	/*
+	 * World scanner constructor
+	 * (a count of 0 uses one worker per hardware thread)
+	 */
+	explicit world_scanner(world &wld, unsigned int count = 0) : pool(count), wld(&wld) { return; }
+
+	/*
+	 * World scanner destructor
+	 */
+	virtual ~world_scanner(void) { return; }
+
+	/*
+	 * World scanner assignment operator
+	 */
+	world_scanner &operator=(const world_scanner &other);
+
+	/*
+	 * World scanner equals operator
+	 */
+	bool operator==(const world_scanner &other);
+
+	/*
+	 * World scanner not-equals operator
+	 */
+	bool operator!=(const world_scanner &other) { return !(*this == other); }
+
+	/*
+	 * Returns a scanner's worker count
+	 */
+	unsigned int get_thread_count(void) { return pool.get_thread_count(); }
+
+	/*
+	 * Visit every chunk of a world: each region is read by one task, which fans out into a decode-and-visit task
+	 * per chunk; idle workers steal tasks, so large regions are split across workers
+	 * (the visitor is called concurrently, and decodes the tags selected by the world's filter)
+	 */
+	void scan(const visitor &func);
+
+	/*
+	 * Visit every chunk of a world, as scan does, with the visitor updating a per-worker partial result,
+	 * then reduce the partial results in worker order
+	 * (each partial result starts as a copy of init, which should be an identity of reduce)
+	 */
+	template <class T, class V, class R>
+	T scan(V visit, R reduce, const T &init) {
+		T result = init;
+		std::vector<T> partials(get_thread_count(), init);
+
+		// visit chunks into per-worker partial results
+		scan([&](unsigned int worker, int c_x, int c_z, chunk_tag &tag) {
+			visit(c_x, c_z, tag, partials.at(worker));
+		});
+
+		// reduce partial results
+		for(unsigned int i = 0; i < partials.size(); ++i)
+			reduce(result, partials.at(i));
+		return result;
+	}
+
+	/*
+	 * Returns a string representation of a world scanner
+	 */
+	std::string to_string(void);
+};
+
+#endif // WORLD_SCANNER_H_
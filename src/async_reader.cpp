@@ -0,0 +1,487 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include "../include/async_reader.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ASYNC_READER_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif // __has_include
+#endif // __linux__
+
+#ifdef ASYNC_READER_URING
+
+/*
+ * io_uring state (submission and completion rings, mapped from the kernel)
+ */
+struct async_reader::ring {
+	int fd;
+	size_t cq_size, sq_size, sqes_size;
+	void *cq_ptr, *sq_ptr;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	unsigned int *cq_head, *cq_mask, *cq_tail, *sq_array, *sq_head, *sq_mask, *sq_tail;
+};
+
+#else
+
+/*
+ * io_uring state (unused)
+ */
+struct async_reader::ring {
+	int fd;
+};
+
+#endif // ASYNC_READER_URING
+
+/*
+ * Async reader constructor
+ */
+async_reader::async_reader(unsigned int depth, unsigned int count, BACKEND preferred) : backend(PREAD),
+		depth(depth ? depth : 1), outstanding(0), pool(count), stopping(false) {
+
+	// prefer io_uring, with a single thread keeping every read in flight
+	if(preferred == IO_URING
+			&& start_uring()) {
+		backend = IO_URING;
+		workers.push_back(std::thread(&async_reader::run_uring, this));
+		return;
+	}
+
+	// otherwise keep one blocking pread in flight per thread
+	for(unsigned int i = 0; i < this->depth; ++i)
+		workers.push_back(std::thread(&async_reader::run_pread, this));
+}
+
+/*
+ * Async reader destructor
+ */
+async_reader::~async_reader(void) {
+	std::map<std::string, int>::iterator iter;
+
+	// finish pending reads, dropping any failure
+	try {
+		wait();
+	} catch(...) {
+	}
+
+	// stop and join the i/o threads
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	ready.notify_all();
+	for(unsigned int i = 0; i < workers.size(); ++i)
+		workers.at(i).join();
+	stop_uring();
+
+	// close files
+	for(iter = files.begin(); iter != files.end(); ++iter)
+		::close(iter->second);
+}
+
+/*
+ * Async reader equals operator
+ */
+bool async_reader::operator==(const async_reader &other) {
+	return this == &other;
+}
+
+/*
+ * Hand a finished read to a decode worker
+ */
+void async_reader::complete(request &req, std::vector<char> &data, bool failed) {
+
+	// failures surface from wait, through the pool
+	if(failed)
+		pool.submit([](unsigned int worker) {
+			throw std::runtime_error("Failed to read chunk data");
+		});
+	else {
+		std::shared_ptr<std::vector<char>> value = std::make_shared<std::vector<char>>();
+		completion func = req.func;
+		value->swap(data);
+		pool.submit([value, func](unsigned int worker) {
+			func(worker, *value);
+		});
+	}
+
+	// signal waiters once the last read is handed off
+	std::lock_guard<std::mutex> guard(lock);
+	if(!--outstanding)
+		idle.notify_all();
+}
+
+/*
+ * Returns an open file descriptor for a given path
+ */
+int async_reader::get_file(const std::string &path) {
+	int fd;
+	std::lock_guard<std::mutex> guard(lock);
+	std::map<std::string, int>::iterator iter = files.find(path);
+
+	// reuse open files
+	if(iter != files.end())
+		return iter->second;
+
+	// attempt to open file
+	fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw std::runtime_error("Failed to open input file");
+	files[path] = fd;
+	return fd;
+}
+
+/*
+ * Queue a read of a byte range of a file
+ */
+void async_reader::read(const std::string &path, unsigned long long offset, unsigned int length, const completion &func) {
+	request req;
+
+	// queue the request, then wake an i/o thread
+	req.fd = get_file(path);
+	req.offset = offset;
+	req.length = length;
+	req.func = func;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		++outstanding;
+		requests.push_back(req);
+	}
+	ready.notify_one();
+}
+
+/*
+ * Queue a read of a single chunk at a given x, z coord
+ */
+void async_reader::read_chunk(const std::shared_ptr<region_file_reader> &reader, unsigned int x, unsigned int z,
+		const std::function<void(unsigned int, chunk_tag &)> &func) {
+	std::string path;
+	unsigned int length;
+	unsigned long long offset;
+
+	// skip missing chunks
+	if(!reader->get_chunk_location(x, z, path, offset, length))
+		return;
+
+	// decode on the worker that receives the data
+	read(path, offset, length, [reader, x, z, func](unsigned int worker,
+			std::vector<char> &data) {
+		chunk_tag tag;
+		reader->decode_chunk_data(x, z, data, tag);
+		func(worker, tag);
+	});
+}
+
+/*
+ * Run the pread backend's I/O loop
+ */
+void async_reader::run_pread(void) {
+	request req;
+
+	while(take(req, true)) {
+		unsigned int done = 0;
+		std::vector<char> data(req.length, 0);
+		bool failed = !read_fully(req, data, done);
+
+		data.resize(done);
+		complete(req, data, failed);
+	}
+}
+
+/*
+ * Read the rest of a request's bytes with blocking preads, returning false on failure
+ */
+bool async_reader::read_fully(request &req, std::vector<char> &data, unsigned int &done) {
+	ssize_t result;
+
+	// read until done, or the end of the file
+	while(done < req.length) {
+		result = ::pread(req.fd, &data[done], req.length - done, req.offset + done);
+		if(result < 0
+				&& errno == EINTR)
+			continue;
+		if(result < 0)
+			return false;
+		if(!result)
+			break;
+		done += result;
+	}
+	return true;
+}
+
+/*
+ * Run the io_uring backend's I/O loop
+ */
+void async_reader::run_uring(void) {
+#ifdef ASYNC_READER_URING
+
+	/*
+	 * In-flight read
+	 */
+	struct slot {
+		request req;
+		std::vector<char> data;
+		struct iovec iov;
+		unsigned int done;
+	};
+
+	unsigned int in_flight = 0, prepared = 0;
+	std::vector<slot> slots(depth);
+	std::vector<unsigned int> free_slots, retry;
+
+	// queue a read of a slot's remaining bytes
+	std::function<void(unsigned int)> prepare = [&](unsigned int index) {
+		slot &value = slots.at(index);
+		unsigned int tail = *uring->sq_tail, entry = tail & *uring->sq_mask;
+		struct io_uring_sqe *sqe = &uring->sqes[entry];
+
+		value.iov.iov_base = &value.data[value.done];
+		value.iov.iov_len = value.req.length - value.done;
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = IORING_OP_READV;
+		sqe->fd = value.req.fd;
+		sqe->off = value.req.offset + value.done;
+		sqe->addr = (unsigned long long) &value.iov;
+		sqe->len = 1;
+		sqe->user_data = index;
+		uring->sq_array[entry] = entry;
+		__atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+		++prepared;
+	};
+
+	// reap completions, keeping short reads to be read on, until done or the end of the file
+	std::function<void(void)> reap = [&](void) {
+		unsigned int head = *uring->cq_head, tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+		for(; head != tail; ++head) {
+			struct io_uring_cqe *cqe = &uring->cqes[head & *uring->cq_mask];
+			unsigned int index = (unsigned int) cqe->user_data;
+			slot &value = slots.at(index);
+
+			if(cqe->res > 0) {
+				value.done += cqe->res;
+				if(value.done < value.req.length) {
+					retry.push_back(index);
+					continue;
+				}
+			}
+			value.data.resize(value.done);
+			complete(value.req, value.data, cqe->res < 0);
+			value.req = request();
+			free_slots.push_back(index);
+			--in_flight;
+		}
+		__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+	};
+
+	for(unsigned int i = 0; i < depth; ++i)
+		free_slots.push_back(depth - 1 - i);
+	for(;;) {
+
+		// requeue short reads, then fill free slots with pending reads (waiting for one only when idle)
+		for(unsigned int i = 0; i < retry.size(); ++i)
+			prepare(retry.at(i));
+		retry.clear();
+		while(!free_slots.empty()) {
+			unsigned int index = free_slots.back();
+			if(!take(slots.at(index).req, !in_flight))
+				break;
+			free_slots.pop_back();
+			slots.at(index).data.assign(slots.at(index).req.length, 0);
+			slots.at(index).done = 0;
+			prepare(index);
+			++in_flight;
+		}
+		if(!in_flight)
+			return;
+
+		// submit prepared reads and wait for at least one completion
+		if(syscall(__NR_io_uring_enter, uring->fd, prepared, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0) {
+			if(errno == EINTR)
+				continue;
+			break;
+		}
+		prepared = 0;
+		reap();
+	}
+
+	// should the ring fail, withdraw the reads it has not consumed, leaving queued only those the kernel holds
+	unsigned int head = __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE), tail = *uring->sq_tail;
+	for(unsigned int i = head; i != tail; ++i)
+		retry.push_back((unsigned int) uring->sqes[uring->sq_array[i & *uring->sq_mask]].user_data);
+	__atomic_store_n(uring->sq_tail, head, __ATOMIC_RELEASE);
+
+	// wait out the reads the kernel holds, since it may write into their buffers until they complete
+	while(in_flight > retry.size()) {
+		reap();
+		if(in_flight > retry.size()
+				&& syscall(__NR_io_uring_enter, uring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	// finish the remaining reads with blocking preads
+	for(unsigned int i = 0; i < retry.size(); ++i) {
+		slot &value = slots.at(retry.at(i));
+		bool failed = !read_fully(value.req, value.data, value.done);
+		value.data.resize(value.done);
+		complete(value.req, value.data, failed);
+	}
+
+	// and everything after them, on as many pread workers as the ring was deep
+	std::vector<std::thread> helpers;
+	for(unsigned int i = 1; i < depth; ++i)
+		helpers.push_back(std::thread(&async_reader::run_pread, this));
+	run_pread();
+	for(unsigned int i = 0; i < helpers.size(); ++i)
+		helpers.at(i).join();
+#endif // ASYNC_READER_URING
+}
+
+/*
+ * Set up io_uring, returning false if it is unavailable
+ */
+bool async_reader::start_uring(void) {
+#ifdef ASYNC_READER_URING
+	struct io_uring_params params;
+	std::unique_ptr<ring> value(new ring());
+
+	// create the rings (fails under older kernels, or where io_uring is disabled)
+	memset(&params, 0, sizeof(params));
+	value->fd = syscall(__NR_io_uring_setup, depth, &params);
+	if(value->fd < 0)
+		return false;
+
+	// map the rings, which share a mapping under newer kernels
+	value->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+	value->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if(params.features & IORING_FEAT_SINGLE_MMAP)
+		value->sq_size = value->cq_size = std::max(value->sq_size, value->cq_size);
+	value->sq_ptr = mmap(NULL, value->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, value->fd,
+			IORING_OFF_SQ_RING);
+	value->cq_ptr = (params.features & IORING_FEAT_SINGLE_MMAP) ? value->sq_ptr
+			: mmap(NULL, value->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, value->fd, IORING_OFF_CQ_RING);
+	value->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	value->sqes = (struct io_uring_sqe *) mmap(NULL, value->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			value->fd, IORING_OFF_SQES);
+	if(value->sq_ptr == MAP_FAILED
+			|| value->cq_ptr == MAP_FAILED
+			|| value->sqes == MAP_FAILED) {
+		if(value->sq_ptr != MAP_FAILED)
+			munmap(value->sq_ptr, value->sq_size);
+		if(value->cq_ptr != MAP_FAILED
+				&& value->cq_ptr != value->sq_ptr)
+			munmap(value->cq_ptr, value->cq_size);
+		if(value->sqes != MAP_FAILED)
+			munmap(value->sqes, value->sqes_size);
+		::close(value->fd);
+		return false;
+	}
+
+	// locate ring fields
+	value->sq_head = (unsigned int *) ((char *) value->sq_ptr + params.sq_off.head);
+	value->sq_tail = (unsigned int *) ((char *) value->sq_ptr + params.sq_off.tail);
+	value->sq_mask = (unsigned int *) ((char *) value->sq_ptr + params.sq_off.ring_mask);
+	value->sq_array = (unsigned int *) ((char *) value->sq_ptr + params.sq_off.array);
+	value->cq_head = (unsigned int *) ((char *) value->cq_ptr + params.cq_off.head);
+	value->cq_tail = (unsigned int *) ((char *) value->cq_ptr + params.cq_off.tail);
+	value->cq_mask = (unsigned int *) ((char *) value->cq_ptr + params.cq_off.ring_mask);
+	value->cqes = (struct io_uring_cqe *) ((char *) value->cq_ptr + params.cq_off.cqes);
+
+	// never keep more reads in flight than the ring holds
+	if(depth > params.sq_entries)
+		depth = params.sq_entries;
+	uring.swap(value);
+	return true;
+#else
+	return false;
+#endif // ASYNC_READER_URING
+}
+
+/*
+ * Tear down io_uring
+ */
+void async_reader::stop_uring(void) {
+#ifdef ASYNC_READER_URING
+
+	// check for io_uring
+	if(!uring)
+		return;
+	munmap(uring->sqes, uring->sqes_size);
+	if(uring->cq_ptr != uring->sq_ptr)
+		munmap(uring->cq_ptr, uring->cq_size);
+	munmap(uring->sq_ptr, uring->sq_size);
+	::close(uring->fd);
+	uring.reset();
+#endif // ASYNC_READER_URING
+}
+
+/*
+ * Take the oldest pending read
+ */
+bool async_reader::take(request &req, bool block) {
+	std::unique_lock<std::mutex> guard(lock);
+
+	// wait for a read, unless told not to
+	if(block)
+		ready.wait(guard, [&](void) { return !requests.empty() || stopping; });
+	if(requests.empty())
+		return false;
+	req = requests.front();
+	requests.pop_front();
+	return true;
+}
+
+/*
+ * Returns a string representation of an async reader
+ */
+std::string async_reader::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << (backend == IO_URING ? "io_uring" : "pread") << ", depth " << depth << ", " << outstanding << " outstanding, "
+			<< pool.to_string();
+	return ss.str();
+}
+
+/*
+ * Wait until every queued read has been read and handed off, and every decode worker has finished
+ */
+void async_reader::wait(void) {
+
+	// wait for the last read to be handed off
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		idle.wait(guard, [&](void) { return !outstanding; });
+	}
+
+	// then for the last decode
+	pool.wait();
+}
@@ -0,0 +1,175 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include "../include/block_histogram.h"
+#include "../include/chunk_section.h"
+#include "../include/region_file_reader.h"
+
+/*
+ * Block histogram assignment operator
+ */
+block_histogram &block_histogram::operator=(const block_histogram &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	counts = other.counts;
+	return *this;
+}
+
+/*
+ * Block histogram equals operator
+ */
+bool block_histogram::operator==(const block_histogram &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return counts == other.counts;
+}
+
+/*
+ * Add another histogram's counts to a block histogram
+ */
+void block_histogram::add(const block_histogram &other) {
+	for(unsigned int i = 0; i < ID_COUNT; ++i)
+		counts[i] += other.counts[i];
+}
+
+/*
+ * Reset a block histogram's counts
+ */
+void block_histogram::clear(void) {
+	counts.assign(ID_COUNT, 0);
+}
+
+/*
+ * Count the blocks of a region's filled chunks, limited to a y range and chunk mask
+ */
+void block_histogram::count(region &reg, int min_y, int max_y, const std::bitset<region_dim::CHUNK_COUNT> &mask,
+		parallel::POLICY policy) {
+	static const unsigned int LANE_COUNT = 4;
+	std::vector<std::vector<unsigned long long> > tables(policy == parallel::PARALLEL ? parallel::get_thread_count() : 1);
+
+	// each worker counts into its own table, spread over several lanes so runs of one id
+	// (stone, air) do not serialize on a single counter
+	parallel::for_each_worker(0, region_dim::CHUNK_COUNT, [&](unsigned int pos, unsigned int worker) {
+		unsigned long long *lanes = NULL;
+		std::vector<chunk_section> sections;
+		int ids[region_dim::SECTION_BLOCK_COUNT];
+
+		// skip missing and masked chunks
+		if(!mask.test(pos)
+				|| !reg.is_filled(pos))
+			return;
+		if(tables.at(worker).empty())
+			tables.at(worker).assign(LANE_COUNT * ID_COUNT, 0);
+		lanes = tables.at(worker).data();
+
+		// count each section's layers that fall within the y range
+		chunk_section::get_sections(reg.get_tag_at(pos), sections);
+		for(unsigned int i = 0; i < sections.size(); ++i) {
+			long long base = (long long) sections.at(i).get_y() * region_dim::SECTION_HEIGHT,
+					low = std::max((long long) min_y - base, 0LL),
+					high = std::min((long long) max_y - base + 1, (long long) region_dim::SECTION_HEIGHT);
+			unsigned int begin, end;
+
+			// skip sections outside of the y range
+			if(low >= high)
+				continue;
+			begin = low * region_dim::BLOCK_COUNT;
+			end = high * region_dim::BLOCK_COUNT;
+			sections.at(i).get_blocks(ids);
+			for(unsigned int j = begin; j < end; j += LANE_COUNT) {
+				++lanes[ids[j]];
+				++lanes[ID_COUNT + ids[j + 1]];
+				++lanes[(2 * ID_COUNT) + ids[j + 2]];
+				++lanes[(3 * ID_COUNT) + ids[j + 3]];
+			}
+		}
+	}, policy);
+
+	// merge the tables in worker order
+	for(unsigned int i = 0; i < tables.size(); ++i) {
+		if(tables.at(i).empty())
+			continue;
+		for(unsigned int j = 0; j < LANE_COUNT; ++j)
+			for(unsigned int k = 0; k < ID_COUNT; ++k)
+				counts[k] += tables.at(i).at(j * ID_COUNT + k);
+	}
+}
+
+/*
+ * Count the blocks of a list of region files, one file at a time, limited to a y range and chunk mask
+ */
+void block_histogram::count(const std::vector<std::string> &paths, int min_y, int max_y,
+		const std::bitset<region_dim::CHUNK_COUNT> &mask, parallel::POLICY policy) {
+
+	// only block data is decoded, and each region is released before the next is read
+	for(unsigned int i = 0; i < paths.size(); ++i) {
+		region_file_reader reader(paths.at(i));
+		reader.set_filter({ "Sections" });
+		reader.read(policy);
+		count(reader.get_region(), min_y, max_y, mask, policy);
+	}
+}
+
+/*
+ * Returns a block histogram's count for a given block id
+ */
+unsigned long long block_histogram::get_count(unsigned int id) {
+
+	// check for valid id
+	if(id >= ID_COUNT)
+		throw std::out_of_range("id out-of-range");
+	return counts.at(id);
+}
+
+/*
+ * Returns a block histogram's total count
+ */
+unsigned long long block_histogram::get_total(void) {
+	unsigned long long total = 0;
+
+	// sum counts
+	for(unsigned int i = 0; i < ID_COUNT; ++i)
+		total += counts[i];
+	return total;
+}
+
+/*
+ * Returns a string representation of a block histogram
+ */
+std::string block_histogram::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation of non-zero counts
+	ss << "Total: " << get_total();
+	for(unsigned int i = 0; i < ID_COUNT; ++i)
+		if(counts[i])
+			ss << std::endl << i << ": " << counts[i];
+	return ss.str();
+}
@@ -0,0 +1,103 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "../include/bounding_box.h"
+
+/*
+ * Bounding box constructor
+ */
+bounding_box::bounding_box(int x_1, int y_1, int z_1, int x_2, int y_2, int z_2) :
+		max_x(std::max(x_1, x_2)), max_y(std::max(y_1, y_2)), max_z(std::max(z_1, z_2)),
+		min_x(std::min(x_1, x_2)), min_y(std::min(y_1, y_2)), min_z(std::min(z_1, z_2)) {
+	return;
+}
+
+/*
+ * Bounding box assignment operator
+ */
+bounding_box &bounding_box::operator=(const bounding_box &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	max_x = other.max_x;
+	max_y = other.max_y;
+	max_z = other.max_z;
+	min_x = other.min_x;
+	min_y = other.min_y;
+	min_z = other.min_z;
+	return *this;
+}
+
+/*
+ * Bounding box equals operator
+ */
+bool bounding_box::operator==(const bounding_box &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return max_x == other.max_x
+			&& max_y == other.max_y
+			&& max_z == other.max_z
+			&& min_x == other.min_x
+			&& min_y == other.min_y
+			&& min_z == other.min_z;
+}
+
+/*
+ * Returns true if a bounding box contains a given world coord
+ */
+bool bounding_box::contains(int x, int y, int z) const {
+	return x >= min_x && x <= max_x
+			&& y >= min_y && y <= max_y
+			&& z >= min_z && z <= max_z;
+}
+
+/*
+ * Returns the intersection of two bounding boxes, returning false if they do not intersect
+ */
+bool bounding_box::intersect(const bounding_box &other, bounding_box &result) const {
+
+	// check for overlap along each axis
+	if(other.min_x > max_x || other.max_x < min_x
+			|| other.min_y > max_y || other.max_y < min_y
+			|| other.min_z > max_z || other.max_z < min_z)
+		return false;
+	result = bounding_box(std::max(min_x, other.min_x), std::max(min_y, other.min_y), std::max(min_z, other.min_z),
+			std::min(max_x, other.max_x), std::min(max_y, other.max_y), std::min(max_z, other.max_z));
+	return true;
+}
+
+/*
+ * Returns a string representation of a bounding box
+ */
+std::string bounding_box::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << "(" << min_x << ", " << min_y << ", " << min_z << ") - (" << max_x << ", " << max_y << ", " << max_z << ")";
+	return ss.str();
+}
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
 #include <sstream>
 #include "../include/byte_stream.h"
 
@@ -187,6 +188,21 @@ bool byte_stream::operator>>(double &output) {
 	return read_stream_float<double>(output);
 }
 
+/*
+ * Byte stream output of a given length
+ */
+bool byte_stream::read(char *output, unsigned int length) {
+
+	// check if enough of the stream remains
+	if(length > buff.size() - pos)
+		return END_OF_STREAM;
+
+	// copy bytes from stream
+	memcpy(output, buff.data() + pos, length);
+	pos += length;
+	return SUCCESS;
+}
+
 /*
  * Returns the available bytes left in the stream
  */
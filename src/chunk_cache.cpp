@@ -0,0 +1,262 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include "../include/chunk_cache.h"
+
+/*
+ * Chunk cache assignment operator
+ */
+chunk_cache &chunk_cache::operator=(const chunk_cache &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes, dropping any cached chunks
+	std::lock_guard<std::mutex> guard(lock);
+	entries.clear();
+	ring.clear();
+	hand = ring.end();
+	budget = other.budget;
+	size = 0;
+	hits = 0;
+	misses = 0;
+	wld = other.wld;
+	return *this;
+}
+
+/*
+ * Chunk cache equals operator
+ */
+bool chunk_cache::operator==(const chunk_cache &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return budget == other.budget
+			&& wld == other.wld;
+}
+
+/*
+ * Remove all of a cache's unpinned chunks
+ */
+void chunk_cache::clear(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	std::map<key, entry>::iterator iter = entries.begin();
+
+	// remove each unpinned chunk
+	while(iter != entries.end())
+		if(!iter->second.pins)
+			remove(iter++);
+		else
+			++iter;
+}
+
+/*
+ * Returns true if a chunk at a given world chunk coord is cached
+ */
+bool chunk_cache::contains(int c_x, int c_z) {
+	std::lock_guard<std::mutex> guard(lock);
+	return entries.find(get_key(c_x, c_z)) != entries.end();
+}
+
+/*
+ * Evict unpinned chunks, in clock order, until the cache fits its budget
+ */
+void chunk_cache::evict(void) {
+	unsigned long long steps = 0;
+
+	// sweep the ring, giving referenced chunks a second chance, and stop once
+	// two full sweeps pass without an eviction (everything left is pinned)
+	while(size > budget
+			&& !ring.empty()
+			&& steps <= 2 * ring.size()) {
+		if(hand == ring.end())
+			hand = ring.begin();
+		std::map<key, entry>::iterator iter = entries.find(*hand);
+		if(iter->second.pins) {
+			++hand;
+			++steps;
+		} else if(iter->second.referenced) {
+			iter->second.referenced = false;
+			++hand;
+			++steps;
+		} else {
+			remove(iter);
+			steps = 0;
+		}
+	}
+}
+
+/*
+ * Returns a cached chunk at a given world chunk coord, reading it on a miss
+ */
+std::shared_ptr<chunk_tag> chunk_cache::fetch(int c_x, int c_z, bool pin) {
+	key k = get_key(c_x, c_z);
+	std::shared_ptr<chunk_tag> tag;
+	std::map<key, entry>::iterator iter;
+
+	// check for a cached chunk
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		iter = entries.find(k);
+		if(iter != entries.end()) {
+			++hits;
+			iter->second.referenced = true;
+			if(pin)
+				++iter->second.pins;
+			return iter->second.tag;
+		}
+		++misses;
+	}
+
+	// read the chunk outside of the lock, so misses do not serialize
+	if(!wld)
+		throw std::runtime_error("Chunk cache has no world");
+	tag = std::make_shared<chunk_tag>();
+	if(!wld->read_chunk(c_x, c_z, *tag))
+		return std::shared_ptr<chunk_tag>();
+	unsigned long long tag_size = tag->get_size();
+
+	// keep the copy of a concurrent reader that got there first
+	std::lock_guard<std::mutex> guard(lock);
+	iter = entries.find(k);
+	if(iter != entries.end()) {
+		iter->second.referenced = true;
+		if(pin)
+			++iter->second.pins;
+		return iter->second.tag;
+	}
+
+	// insert behind the hand, so the chunk survives at least one full sweep
+	entry &value = entries[k];
+	value.tag = tag;
+	value.size = tag_size;
+	value.pins = pin ? 1 : 0;
+	value.referenced = true;
+	value.position = ring.insert(hand, k);
+	size += tag_size;
+	evict();
+	return tag;
+}
+
+/*
+ * Returns a cache's budget (in bytes)
+ */
+unsigned long long chunk_cache::get_budget(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return budget;
+}
+
+/*
+ * Returns a cache's chunk count
+ */
+unsigned int chunk_cache::get_count(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return entries.size();
+}
+
+/*
+ * Returns the cache key of a given world chunk coord
+ */
+chunk_cache::key chunk_cache::get_key(int c_x, int c_z) {
+	unsigned int x, z;
+	world::coord reg;
+
+	// key on region coord and chunk index
+	world::get_chunk_coord(c_x, c_z, reg, x, z);
+	return key(reg.first, reg.second, z * region_dim::CHUNK_WIDTH + x);
+}
+
+/*
+ * Returns a cache's hit count
+ */
+unsigned long long chunk_cache::get_hits(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return hits;
+}
+
+/*
+ * Returns a cache's miss count
+ */
+unsigned long long chunk_cache::get_misses(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return misses;
+}
+
+/*
+ * Returns the memory held by a cache's chunks (in bytes)
+ */
+unsigned long long chunk_cache::get_size(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return size;
+}
+
+/*
+ * Remove a cached chunk
+ */
+void chunk_cache::remove(std::map<key, entry>::iterator iter) {
+
+	// move the hand off of the removed chunk
+	if(hand == iter->second.position)
+		++hand;
+	ring.erase(iter->second.position);
+	size -= iter->second.size;
+	entries.erase(iter);
+}
+
+/*
+ * Sets a cache's budget, evicting chunks as needed
+ */
+void chunk_cache::set_budget(unsigned long long budget) {
+	std::lock_guard<std::mutex> guard(lock);
+	this->budget = budget;
+	evict();
+}
+
+/*
+ * Returns a string representation of a chunk cache
+ */
+std::string chunk_cache::to_string(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	std::stringstream ss;
+
+	// form string representation
+	ss << entries.size() << " chunks, " << size << "/" << budget << " bytes (" << hits << " hits, " << misses << " misses)";
+	return ss.str();
+}
+
+/*
+ * Unpin a chunk at a given world chunk coord
+ */
+void chunk_cache::unpin(int c_x, int c_z) {
+	std::lock_guard<std::mutex> guard(lock);
+	std::map<key, entry>::iterator iter = entries.find(get_key(c_x, c_z));
+
+	// check for a pinned chunk
+	if(iter == entries.end()
+			|| !iter->second.pins)
+		throw std::runtime_error("Chunk is not pinned");
+	--iter->second.pins;
+	evict();
+}
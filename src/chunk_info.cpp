@@ -61,7 +61,7 @@ std::string chunk_info::to_string(void) {
 
 	// form string representation
 	ss << "[";
-	switch(type) {
+	switch((unsigned char) type & ~EXTERNAL) {
 		case GZIP: ss << "GZIP";
 			break;
 		case ZLIB: ss << "ZLIB";
@@ -69,6 +69,8 @@ std::string chunk_info::to_string(void) {
 		default: ss << "UNKNOWN";
 			break;
 	}
+	if(is_external())
+		ss << ", EXTERNAL";
 	ss << "] off: " << offset << ", len: " << length << ", modified: " << modified;
 	return ss.str();
 }
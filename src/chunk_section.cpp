@@ -0,0 +1,259 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include "../include/chunk_section.h"
+#include "../include/tag/byte_tag.h"
+#include "../include/tag/compound_tag.h"
+#include "../include/tag/int_tag.h"
+#include "../include/tag/list_tag.h"
+
+/*
+ * Chunk section assignment operator
+ */
+chunk_section &chunk_section::operator=(const chunk_section &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	add = other.add;
+	blocks = other.blocks;
+	y = other.y;
+	return *this;
+}
+
+/*
+ * Chunk section equals operator
+ */
+bool chunk_section::operator==(const chunk_section &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return add == other.add
+			&& blocks == other.blocks
+			&& y == other.y;
+}
+
+/*
+ * Returns a section's all-air status
+ */
+bool chunk_section::empty(void) {
+	unsigned long long word = 0;
+	const char *data = NULL;
+
+	// check for missing block data
+	if(!blocks)
+		return true;
+
+	// or together the block data one word at a time
+	data = blocks->get_value().data();
+	for(unsigned int i = 0; i < region_dim::SECTION_BLOCK_COUNT; i += sizeof(word)) {
+		unsigned long long value;
+		memcpy(&value, data + i, sizeof(value));
+		word |= value;
+	}
+	return !word;
+}
+
+/*
+ * Returns a section's block id at a given index
+ */
+int chunk_section::get_block_at(unsigned int index) {
+	int id;
+
+	// check for valid index
+	if(!blocks
+			|| index >= region_dim::SECTION_BLOCK_COUNT)
+		throw std::out_of_range("index out-of-range");
+	id = (unsigned char) blocks->at(index);
+
+	// apply the high bits stored as nibbles in the "Add" tag
+	if(add)
+		id |= ((add->at(index >> 1) >> ((index & 1) * 4)) & 0xf) << 8;
+	return id;
+}
+
+/*
+ * Returns a section's block id at a given b coord
+ */
+int chunk_section::get_block_at(unsigned int b_x, unsigned int b_y, unsigned int b_z) {
+
+	// check coordinates
+	if(b_x >= region_dim::BLOCK_WIDTH
+			|| b_y >= region_dim::SECTION_HEIGHT
+			|| b_z >= region_dim::BLOCK_WIDTH)
+		throw std::out_of_range("coordinates out-of-range");
+	return get_block_at((b_y * region_dim::BLOCK_WIDTH + b_z) * region_dim::BLOCK_WIDTH + b_x);
+}
+
+/*
+ * Returns a section's block ids, indexed by (y * 16 + z) * 16 + x
+ */
+void chunk_section::get_blocks(int (&ids)[region_dim::SECTION_BLOCK_COUNT]) {
+	const unsigned char *high = NULL, *low = NULL;
+
+	// check for missing block data
+	if(!blocks) {
+		memset(ids, 0, sizeof(ids));
+		return;
+	}
+
+	// widen the low bits
+	low = reinterpret_cast<const unsigned char *>(blocks->get_value().data());
+	for(unsigned int i = 0; i < region_dim::SECTION_BLOCK_COUNT; ++i)
+		ids[i] = low[i];
+
+	// apply the high bits, two blocks per byte
+	if(!add)
+		return;
+	high = reinterpret_cast<const unsigned char *>(add->get_value().data());
+	for(unsigned int i = 0; i < region_dim::SECTION_BLOCK_COUNT; i += 2) {
+		ids[i] |= (high[i >> 1] & 0xf) << 8;
+		ids[i + 1] |= (high[i >> 1] & 0xf0) << 4;
+	}
+}
+
+/*
+ * Collect a chunk's sections that carry block data, in ascending y order
+ */
+void chunk_section::get_sections(const chunk_tag &tag, std::vector<chunk_section> &sections) {
+	list_tag *list = NULL;
+	generic_tag *section_list = NULL;
+
+	// sections live under "Level" in anvil chunks
+	sections.clear();
+	section_list = tag.get_level_tag().find("Sections");
+	if(!section_list
+			|| section_list->get_type() != generic_tag::LIST)
+		return;
+	list = static_cast<list_tag *>(section_list);
+	if(list->get_element_type() != generic_tag::COMPOUND)
+		return;
+
+	// collect each section's y coord and block tags
+	for(unsigned int i = 0; i < list->size(); ++i) {
+		compound_tag *section = static_cast<compound_tag *>(list->at(i));
+		generic_tag *add = section->find("Add"), *blocks = section->find("Blocks"), *y = section->find("Y");
+
+		// skip sections without block data
+		if(!blocks
+				|| blocks->get_type() != generic_tag::BYTE_ARRAY)
+			continue;
+		if(!y
+				|| y->get_type() != generic_tag::BYTE
+				|| static_cast<byte_array_tag *>(blocks)->size() != region_dim::SECTION_BLOCK_COUNT)
+			throw std::runtime_error("Malformed chunk section");
+		if(add
+				&& (add->get_type() != generic_tag::BYTE_ARRAY
+				|| static_cast<byte_array_tag *>(add)->size() != (region_dim::SECTION_BLOCK_COUNT / 2)))
+			add = NULL;
+		sections.push_back(chunk_section(static_cast<byte_tag *>(y)->get_value(), static_cast<byte_array_tag *>(blocks),
+				static_cast<byte_array_tag *>(add)));
+	}
+	std::sort(sections.begin(), sections.end(), [](const chunk_section &left, const chunk_section &right) {
+		return left.y < right.y;
+	});
+}
+
+/*
+ * Returns a chunk's section list, or NULL if it has none
+ */
+const list_tag *chunk_section::get_section_list(const chunk_tag &tag) {
+	const generic_tag *section_list = NULL;
+
+	// sections live under "Level" before 1.18, and at the root ("sections") since
+	section_list = tag.get_level_tag().find("Sections");
+	if(!section_list)
+		section_list = tag.get_level_tag().find("sections");
+	if(!section_list
+			|| section_list->get_type() != generic_tag::LIST
+			|| static_cast<const list_tag *>(section_list)->get_element_type() != generic_tag::COMPOUND)
+		return NULL;
+	return static_cast<const list_tag *>(section_list);
+}
+
+/*
+ * Collect the y coords of a chunk's sections that carry block data, in either block encoding
+ */
+void chunk_section::get_section_coords(const chunk_tag &tag, std::vector<int> &coords) {
+	const list_tag *list = get_section_list(tag);
+
+	coords.clear();
+	if(!list)
+		return;
+
+	// skip light-only sections, reading y as a byte (anvil) or an int (some converters)
+	for(unsigned int i = 0; i < list->size(); ++i) {
+		const compound_tag *section = static_cast<const compound_tag *>(list->at(i));
+		const generic_tag *y = section->find("Y");
+		if(!section->find("Blocks")
+				&& !section->find("BlockStates")
+				&& !section->find("block_states"))
+			continue;
+		if(y
+				&& y->get_type() == generic_tag::BYTE)
+			coords.push_back(static_cast<const byte_tag *>(y)->get_value());
+		else if(y
+				&& y->get_type() == generic_tag::INT)
+			coords.push_back(static_cast<const int_tag *>(y)->get_value());
+		else
+			throw std::runtime_error("Malformed chunk section");
+	}
+	std::sort(coords.begin(), coords.end());
+}
+
+/*
+ * Returns true if any of a chunk's sections store palette block states
+ */
+bool chunk_section::has_palette(const chunk_tag &tag) {
+	const list_tag *list = get_section_list(tag);
+
+	if(!list)
+		return false;
+
+	// look for block states in place of block ids
+	for(unsigned int i = 0; i < list->size(); ++i) {
+		const compound_tag *section = static_cast<const compound_tag *>(list->at(i));
+		if(section->find("BlockStates")
+				|| section->find("block_states"))
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Returns a string representation of a chunk section
+ */
+std::string chunk_section::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << "Y: " << y << (empty() ? " (EMPTY)" : "");
+	if(add)
+		ss << ", add";
+	return ss.str();
+}
@@ -0,0 +1,249 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "../include/chunk_streamer.h"
+
+/*
+ * Chunk streamer constructor
+ */
+chunk_streamer::chunk_streamer(world &wld, const callback &func, unsigned int window, unsigned int count) : center_x(0),
+		center_z(0), radius(0), func(func), reader(window ? window : 1, count), stopping(false), window(window ? window : 1),
+		wld(wld) {
+	return;
+}
+
+/*
+ * Chunk streamer destructor
+ */
+chunk_streamer::~chunk_streamer(void) {
+
+	// drop everything still queued, then let reads in flight finish
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		queue.clear();
+		loaded.clear();
+		stopping = true;
+	}
+	try {
+		reader.wait();
+	} catch(...) {
+	}
+}
+
+/*
+ * Read or decode a finished chunk read
+ */
+void chunk_streamer::finish(const coord &chunk, const std::shared_ptr<region_file_reader> &region, unsigned int x, unsigned int z,
+		std::vector<char> &data) {
+	chunk_tag tag;
+	bool deliver = false;
+
+	// drop chunks that fell out of range while in flight, without decoding them
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		in_flight.erase(chunk);
+		if(!stopping
+				&& in_range(chunk)) {
+			loaded.insert(chunk);
+			deliver = true;
+		}
+	}
+
+	// decode and deliver, then keep the window full
+	try {
+		if(deliver) {
+			region->decode_chunk_data(x, z, data, tag);
+			func(chunk.first, chunk.second, tag);
+		}
+	} catch(...) {
+		pump();
+		throw;
+	}
+	pump();
+}
+
+/*
+ * Returns a streamer's loaded chunk count
+ */
+unsigned int chunk_streamer::get_loaded_count(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return loaded.size();
+}
+
+/*
+ * Returns a streamer's queued chunk count
+ */
+unsigned int chunk_streamer::get_queued_count(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return queue.size();
+}
+
+/*
+ * Returns true if a chunk lies within range of the center
+ */
+bool chunk_streamer::in_range(const coord &chunk) {
+	long long d_x = (long long) chunk.first - center_x, d_z = (long long) chunk.second - center_z;
+	return (d_x * d_x) + (d_z * d_z) <= (long long) radius * radius;
+}
+
+/*
+ * Returns true if a chunk at a given world chunk coord has been delivered (or found missing) within range
+ */
+bool chunk_streamer::is_loaded(int c_x, int c_z) {
+	std::lock_guard<std::mutex> guard(lock);
+	return loaded.find(coord(c_x, c_z)) != loaded.end();
+}
+
+/*
+ * Issue reads of the nearest queued chunks, up to the window
+ */
+void chunk_streamer::pump(void) {
+
+	for(;;) {
+		world::coord reg;
+		std::string path;
+		unsigned int length, x, z;
+		unsigned long long offset;
+		coord chunk;
+		bool found = false;
+		std::shared_ptr<region_file_reader> region;
+
+		// claim the nearest queued chunk, counting it in flight while its region is resolved
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if(stopping
+					|| queue.empty()
+					|| in_flight.size() >= window)
+				return;
+			chunk = queue.back();
+			queue.pop_back();
+			in_flight.insert(chunk);
+		}
+
+		// resolve the chunk's region outside the lock, since opening a reader reads its header
+		world::get_chunk_coord(chunk.first, chunk.second, reg, x, z);
+		try {
+			region = wld.get_reader(reg);
+			found = region
+					&& region->get_chunk_location(x, z, path, offset, length);
+		} catch(...) {
+			std::lock_guard<std::mutex> guard(lock);
+			in_flight.erase(chunk);
+			throw;
+		}
+
+		// chunks in missing regions, or missing from their region, load as nothing
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if(stopping
+					|| !found) {
+				in_flight.erase(chunk);
+				if(!stopping
+						&& in_range(chunk))
+					loaded.insert(chunk);
+				continue;
+			}
+		}
+
+		// read the chunk, deciding once it arrives whether it is still wanted
+		reader.read(path, offset, length, [this, chunk, region, x, z](unsigned int worker,
+				std::vector<char> &data) {
+			finish(chunk, region, x, z, data);
+		});
+	}
+}
+
+/*
+ * Move a streamer's center and radius
+ */
+void chunk_streamer::set_center(int c_x, int c_z, unsigned int radius) {
+	std::vector<std::pair<long long, coord>> order;
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		std::set<coord>::iterator iter;
+
+		// forget loaded chunks that fall out of range
+		center_x = c_x;
+		center_z = c_z;
+		this->radius = radius;
+		for(iter = loaded.begin(); iter != loaded.end();)
+			if(!in_range(*iter))
+				loaded.erase(iter++);
+			else
+				++iter;
+
+		// queue every chunk in range not yet loaded or in flight, ordered by distance (farthest first, so the nearest pops first)
+		for(long long z = (long long) c_z - radius; z <= (long long) c_z + radius; ++z)
+			for(long long x = (long long) c_x - radius; x <= (long long) c_x + radius; ++x) {
+				coord chunk((int) x, (int) z);
+				if(!in_range(chunk)
+						|| loaded.find(chunk) != loaded.end()
+						|| in_flight.find(chunk) != in_flight.end())
+					continue;
+				order.push_back(std::make_pair(((x - c_x) * (x - c_x)) + ((z - c_z) * (z - c_z)), chunk));
+			}
+		std::sort(order.begin(), order.end(), [](const std::pair<long long, coord> &left, const std::pair<long long, coord> &right) {
+			return left.first > right.first;
+		});
+		queue.clear();
+		for(unsigned int i = 0; i < order.size(); ++i)
+			queue.push_back(order.at(i).second);
+	}
+
+	// start reading
+	pump();
+}
+
+/*
+ * Returns a string representation of a chunk streamer
+ */
+std::string chunk_streamer::to_string(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	std::stringstream ss;
+
+	// form string representation
+	ss << "Center: (" << center_x << ", " << center_z << "), Radius: " << radius << ", Loaded: " << loaded.size()
+			<< ", In flight: " << in_flight.size() << ", Queued: " << queue.size();
+	return ss.str();
+}
+
+/*
+ * Wait until every chunk within range has been delivered
+ */
+void chunk_streamer::wait(void) {
+
+	// finished reads may issue more reads, so wait until none remain
+	for(;;) {
+		reader.wait();
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if(in_flight.empty()
+					&& queue.empty())
+				return;
+		}
+
+		// a chunk's region may still be resolving, before its read is issued
+		std::this_thread::yield();
+	}
+}
@@ -28,6 +28,7 @@
 #include "../include/tag/int_array_tag.h"
 #include "../include/tag/list_tag.h"
 #include "../include/tag/long_tag.h"
+#include "../include/tag/long_array_tag.h"
 #include "../include/tag/short_tag.h"
 #include "../include/tag/string_tag.h"
 
@@ -42,6 +43,9 @@ chunk_tag &chunk_tag::operator=(const chunk_tag &other) {
 
 	// assign attributes
 	root = other.root;
+	modified = other.modified;
+	original = other.original;
+	original_type = other.original_type;
 	return *this;
 }
 
@@ -64,10 +68,15 @@ bool chunk_tag::operator==(const chunk_tag &other) {
 void chunk_tag::copy(chunk_tag &other) {
 	std::vector<generic_tag *> value;
 
+	// check for self
+	if(this == &other)
+		return;
+
 	// clear old tag and assign new tag
 	clean_root();
-	root.set_name(other.get_root_tag().get_name());
-	value = other.get_root_tag().get_value();
+	root.get_value().clear();
+	root.set_name(other.root.get_name());
+	value = other.root.get_value();
 	for(unsigned int i = 0; i < value.size(); ++i) {
 		generic_tag *sub_tag = NULL;
 		sub_tag = copy_tag(value.at(i));
@@ -76,6 +85,9 @@ void chunk_tag::copy(chunk_tag &other) {
 		else
 			root.push_back(sub_tag);
 	}
+	modified = other.modified;
+	original = other.original;
+	original_type = other.original_type;
 }
 
 /*
@@ -135,6 +147,20 @@ void chunk_tag::clean_root(void) {
 		clean_tag(root.at(i));
 }
 
+/*
+ * Clear a chunk tag's tags and original data, keeping the storage they held for reuse
+ */
+void chunk_tag::clear(void) {
+
+	// release sub-tags, keeping the root and original data capacity
+	clean_root();
+	root.get_value().clear();
+	root.set_name("");
+	original.clear();
+	original_type = 0;
+	modified = false;
+}
+
 /*
  * Clean chunk tag (recursively)
  */
@@ -159,15 +185,105 @@ void chunk_tag::clean_tag(generic_tag *tag) {
 	}
 }
 
+/*
+ * Return a chunk tag's level tag (the root tag, for chunks without one)
+ */
+compound_tag &chunk_tag::get_level_tag(void) {
+	set_modified(true);
+	return const_cast<compound_tag &>(static_cast<const chunk_tag *>(this)->get_level_tag());
+}
+
+/*
+ * Return a chunk tag's level tag (the root tag, for chunks without one), for reading
+ */
+const compound_tag &chunk_tag::get_level_tag(void) const {
+	generic_tag *level = root.find("Level");
+
+	// anvil chunks nest their data under "Level"
+	if(!level
+			|| level->get_type() != generic_tag::COMPOUND)
+		return root;
+	return *static_cast<compound_tag *>(level);
+}
+
+/*
+ * Return the memory held by a chunk tag's tags
+ */
+unsigned long long chunk_tag::get_size(void) {
+	unsigned long long size = sizeof(chunk_tag) + root.name.capacity()
+			+ root.get_value().capacity() * sizeof(generic_tag *) + original.capacity();
+
+	// sum sub-tags
+	for(unsigned int i = 0; i < root.size(); ++i)
+		size += get_tag_size(root.at(i));
+	return size;
+}
+
 /*
  * Returns a chunk tag sub-tag at a given name
  */
 std::vector<generic_tag *> chunk_tag::get_sub_tag_by_name(const std::string &name) {
+	set_modified(true);
+	return static_cast<const chunk_tag *>(this)->get_sub_tag_by_name(name);
+}
+
+/*
+ * Returns a chunk tag sub-tag at a given name, for reading
+ */
+std::vector<generic_tag *> chunk_tag::get_sub_tag_by_name(const std::string &name) const {
 	std::vector<generic_tag *> sub_tag;
-	get_tag_by_name_helper(name, &root, sub_tag);
+	get_tag_by_name_helper(name, const_cast<compound_tag *>(&root), sub_tag);
 	return sub_tag;
 }
 
+/*
+ * Return the memory held by a tag and its sub-tags (recursively)
+ */
+unsigned long long chunk_tag::get_tag_size(generic_tag *tag) {
+	unsigned long long size = tag->name.capacity();
+
+	// size tag based on type
+	switch(tag->get_type()) {
+		case generic_tag::COMPOUND: {
+			compound_tag *cmp = static_cast<compound_tag *>(tag);
+			size += sizeof(compound_tag) + cmp->get_value().capacity() * sizeof(generic_tag *);
+			for(unsigned int i = 0; i < cmp->size(); ++i)
+				size += get_tag_size(cmp->at(i));
+		} break;
+		case generic_tag::LIST: {
+			list_tag *lst = static_cast<list_tag *>(tag);
+			size += sizeof(list_tag) + lst->get_value().capacity() * sizeof(generic_tag *);
+			for(unsigned int i = 0; i < lst->size(); ++i)
+				size += get_tag_size(lst->at(i));
+		} break;
+		case generic_tag::BYTE: size += sizeof(byte_tag);
+			break;
+		case generic_tag::SHORT: size += sizeof(short_tag);
+			break;
+		case generic_tag::INT: size += sizeof(int_tag);
+			break;
+		case generic_tag::LONG: size += sizeof(long_tag);
+			break;
+		case generic_tag::FLOAT: size += sizeof(float_tag);
+			break;
+		case generic_tag::DOUBLE: size += sizeof(double_tag);
+			break;
+		case generic_tag::BYTE_ARRAY: size += sizeof(byte_array_tag) + static_cast<byte_array_tag *>(tag)->get_value().capacity();
+			break;
+		case generic_tag::STRING: size += sizeof(string_tag) + static_cast<string_tag *>(tag)->get_value().capacity();
+			break;
+		case generic_tag::INT_ARRAY: size += sizeof(int_array_tag)
+				+ static_cast<int_array_tag *>(tag)->get_value().capacity() * sizeof(int);
+			break;
+		case generic_tag::LONG_ARRAY: size += sizeof(long_array_tag)
+				+ static_cast<long_array_tag *>(tag)->get_value().capacity() * sizeof(long);
+			break;
+		default: size += sizeof(end_tag);
+			break;
+	}
+	return size;
+}
+
 /*
  * Returns a chunk tag sub-tag at a given name helper
  */
@@ -195,3 +311,39 @@ void chunk_tag::get_tag_by_name_helper(const std::string &name, generic_tag *tag
 		} break;
 	}
 }
+
+/*
+ * Return a chunk tag's root tag, for changing
+ */
+compound_tag &chunk_tag::get_root_tag(void) {
+	set_modified(true);
+	return root;
+}
+
+/*
+ * Sets a chunk tag's modified flag
+ */
+void chunk_tag::set_modified(bool modified) {
+	this->modified = modified;
+
+	// original data no longer matches the tags
+	if(modified)
+		std::vector<char>().swap(original);
+}
+
+/*
+ * Sets a chunk tag's root tag
+ */
+void chunk_tag::set_root_tag(const compound_tag &root) {
+	this->root = root;
+	set_modified(true);
+}
+
+/*
+ * Sets a chunk tag's original compressed data and compression type
+ */
+void chunk_tag::set_original(const std::vector<char> &original, char type) {
+	this->original = original;
+	original_type = type;
+	modified = false;
+}
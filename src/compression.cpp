@@ -17,35 +17,33 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <climits>
 #include <cstring>
 #include <zlib.h>
 #include "../include/compression.h"
+#include "../include/decode_context.h"
 
 /*
- * Deflate a char buffer
+ * Deflate a char buffer with a given level and strategy
  */
-bool compression::deflate_(std::vector<char> &data) {
+bool compression::deflate_(std::vector<char> &data, int level, STRATEGY strategy) {
 	int ret;
 	z_stream zs;
-	char buff[SEG_SIZE];
 	std::vector<char> out_data;
 
 	// initialize zlib structure
 	memset(&zs, 0, sizeof(zs));
-	if(deflateInit(&zs, Z_BEST_COMPRESSION) != Z_OK)
+	if(deflateInit2(&zs, level, Z_DEFLATED, MAX_WBITS, MAX_MEM_LEVEL, strategy) != Z_OK)
 		return false;
+
+	// deflate in one pass, into a buffer sized for the worst case
+	out_data.resize(deflateBound(&zs, data.size()));
 	zs.next_in = (Bytef *) data.data();
 	zs.avail_in = data.size();
-
-	// deflate blocks
-	do {
-		zs.next_out = reinterpret_cast<Bytef *>(buff);
-		zs.avail_out = SEG_SIZE;
-
-		// deflate data and place in out_data
-		ret = deflate(&zs, Z_FINISH);
-		out_data.insert(out_data.end(), buff, buff + zs.total_out);
-	} while(ret == Z_OK);
+	zs.next_out = (Bytef *) out_data.data();
+	zs.avail_out = out_data.size();
+	ret = deflate(&zs, Z_FINISH);
 
 	// check for errors
 	deflateEnd(&zs);
@@ -53,50 +51,97 @@ bool compression::deflate_(std::vector<char> &data) {
 		return false;
 
 	// assign to data
-	data = out_data;
+	out_data.resize(zs.total_out);
+	data.swap(out_data);
 	return true;
 }
 
 /*
- * Inflate a char buffer
+ * Deflate a char buffer with a given level and strategy, as independently deflated blocks stitched into a single zlib stream
  */
-bool compression::inflate_(std::vector<char> &data) {
-	int ret;
-	z_stream zs;
-	unsigned long prev_out = 0;
-	std::vector<unsigned char> in_data, out_data;
+bool compression::deflate_blocks_(std::vector<char> &data, int level, STRATEGY strategy, parallel::POLICY policy) {
+	unsigned int header, count = (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	unsigned long check;
+	std::atomic<bool> failed(false);
+	std::vector<unsigned long> checks(count);
+	std::vector<std::vector<char>> blocks(count);
+	std::vector<char> out_data;
 
-	// initialize zlib structure
-	memset(&zs, 0, sizeof(zs));
-	if(inflateInit(&zs) != Z_OK)
+	// a single block gains nothing
+	if(count <= 1)
+		return deflate_(data, level, strategy);
+
+	// deflate each block as raw deflate data, primed with the input preceding it, so the ratio matches a single pass
+	parallel::for_each(0, count, [&](unsigned int i) {
+		int ret;
+		z_stream zs;
+		unsigned int begin = i * BLOCK_SIZE, length = block_length(data.size(), i);
+		std::vector<char> &block = blocks.at(i);
+
+		// initialize zlib structure
+		memset(&zs, 0, sizeof(zs));
+		if(deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, MAX_MEM_LEVEL, strategy) != Z_OK) {
+			failed = true;
+			return;
+		}
+		if(begin
+				&& deflateSetDictionary(&zs, (Bytef *) data.data() + begin - DICT_SIZE, DICT_SIZE) != Z_OK) {
+			deflateEnd(&zs);
+			failed = true;
+			return;
+		}
+
+		// the last block finishes the stream, the rest end on a byte boundary (sync flush) so blocks concatenate
+		block.resize(deflateBound(&zs, length) + SYNC_SIZE);
+		zs.next_in = (Bytef *) data.data() + begin;
+		zs.avail_in = length;
+		zs.next_out = (Bytef *) block.data();
+		zs.avail_out = block.size();
+		ret = deflate(&zs, (i == count - 1) ? Z_FINISH : Z_SYNC_FLUSH);
+		deflateEnd(&zs);
+		if(ret != ((i == count - 1) ? Z_STREAM_END : Z_OK)
+				|| zs.avail_in
+				|| !zs.avail_out) {
+			failed = true;
+			return;
+		}
+		block.resize(zs.total_out);
+		checks.at(i) = adler32(adler32(0, Z_NULL, 0), (Bytef *) data.data() + begin, length);
+	}, policy);
+	if(failed)
 		return false;
 
-	in_data.insert(in_data.begin(), data.begin(), data.end());
-
-	zs.next_in = (Bytef *) in_data.data();
-	zs.avail_in = in_data.size();
-
-	// inflate blocks
-	do {
-		std::vector<unsigned char> buff;
-
-		buff.resize(SEG_SIZE, 0);
-		zs.next_out = (Bytef *) buff.data();
-		zs.avail_out = SEG_SIZE;
-
-		// inflate data and place in out_data
-		ret = inflate(&zs, 0);
-		out_data.insert(out_data.end(), buff.begin(), buff.begin() + (zs.total_out - prev_out));
-		prev_out = zs.total_out;
-	} while(ret == Z_OK);
-
-	// check for errors
-	inflateEnd(&zs);
-	if (ret != Z_STREAM_END)
-		return false;
+	// zlib header, matching the one deflate would write for this level
+	header = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8;
+	if(strategy < HUFFMAN_ONLY
+			&& level >= 2)
+		header |= ((level < 6) ? 1 : ((level == 6) ? 2 : 3)) << 6;
+	header += 31 - (header % 31);
+	out_data.push_back(header >> 8);
+	out_data.push_back(header & UCHAR_MAX);
+
+	// stitch blocks together, combining their checksums
+	check = checks.front();
+	for(unsigned int i = 0; i < count; ++i) {
+		out_data.insert(out_data.end(), blocks.at(i).begin(), blocks.at(i).end());
+		if(i)
+			check = adler32_combine(check, checks.at(i), block_length(data.size(), i));
+	}
+
+	// zlib trailer (big-endian adler32)
+	for(int i = 3; i >= 0; --i)
+		out_data.push_back((check >> (i * CHAR_BIT)) & UCHAR_MAX);
 
 	// assign to data
-	data.clear();
-	data.insert(data.begin(), out_data.begin(), out_data.end());
+	data.swap(out_data);
 	return true;
 }
+
+/*
+ * Inflate a char buffer
+ */
+bool compression::inflate_(std::vector<char> &data) {
+
+	// inflate with the calling thread's reusable stream and buffers
+	return decode_context::get_local().inflate(data);
+}
@@ -0,0 +1,249 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include "../include/compression_policy.h"
+
+/*
+ * Compression policy constructor
+ */
+compression_policy::compression_policy(MODE mode, int level, compression::STRATEGY strategy) : mode(mode), level(level),
+		current(level), strategy(strategy), target(64.0 * 1024 * 1024), threshold(0.9), parallel_size(PARALLEL_SIZE), count(0),
+		bytes_in(0), bytes_out(0), time(0) {
+
+	// check level
+	set_level(level);
+}
+
+/*
+ * Compression policy constructor
+ */
+compression_policy::compression_policy(const compression_policy &other) : mode(other.mode), level(other.level),
+		current(other.current), strategy(other.strategy), target(other.target), threshold(other.threshold),
+		parallel_size(other.parallel_size), count(other.count), bytes_in(other.bytes_in), bytes_out(other.bytes_out),
+		time(other.time) {
+	return;
+}
+
+/*
+ * Compression policy assignment operator
+ */
+compression_policy &compression_policy::operator=(const compression_policy &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	std::lock_guard<std::mutex> guard(lock);
+	mode = other.mode;
+	level = other.level;
+	current = other.current;
+	strategy = other.strategy;
+	target = other.target;
+	threshold = other.threshold;
+	parallel_size = other.parallel_size;
+	count = other.count;
+	bytes_in = other.bytes_in;
+	bytes_out = other.bytes_out;
+	time = other.time;
+	return *this;
+}
+
+/*
+ * Compression policy equals operator
+ */
+bool compression_policy::operator==(const compression_policy &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return mode == other.mode
+			&& level == other.level
+			&& strategy == other.strategy
+			&& target == other.target
+			&& threshold == other.threshold
+			&& parallel_size == other.parallel_size;
+}
+
+/*
+ * Choose the level for a chunk
+ */
+int compression_policy::choose_level(const std::vector<char> &data) {
+
+	// choose level based off mode
+	switch(mode) {
+		case THROUGHPUT: {
+			std::lock_guard<std::mutex> guard(lock);
+			return current;
+		}
+		case ADAPTIVE: {
+
+			// small chunks gain little from higher levels
+			if(data.size() < SMALL_SIZE
+					|| level < compression::MIN_LEVEL)
+				return level < compression::MIN_LEVEL ? level : (int) compression::MIN_LEVEL;
+
+			// sample the middle of larger chunks, deflating those that barely compress at the fastest level
+			unsigned int length = data.size() < SAMPLE_SIZE ? data.size() : SAMPLE_SIZE;
+			std::vector<char>::const_iterator begin = data.begin() + ((data.size() - length) / 2);
+			std::vector<char> sample(begin, begin + length);
+			if(!compression::deflate_(sample, compression::MIN_LEVEL, strategy)
+					|| sample.size() >= threshold * length)
+				return compression::MIN_LEVEL;
+			return level;
+		}
+		default:
+			return level;
+	}
+}
+
+/*
+ * Deflate a char buffer at the level chosen by a compression policy, recording statistics
+ */
+bool compression_policy::deflate(std::vector<char> &data) {
+	bool result;
+	double elapsed;
+	unsigned int length = data.size();
+	int chosen = choose_level(data);
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+	// deflate and time chunk (large chunks in blocks, so one chunk does not serialize a save)
+	if(parallel_size
+			&& length >= parallel_size)
+		result = compression::deflate_blocks_(data, chosen, strategy, parallel::PARALLEL);
+	else
+		result = compression::deflate_(data, chosen, strategy);
+	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	if(!result)
+		return false;
+
+	// record statistics
+	std::lock_guard<std::mutex> guard(lock);
+	++count;
+	bytes_in += length;
+	bytes_out += data.size();
+	time += elapsed;
+
+	// step the level toward the throughput target, from what this chunk achieved
+	if(mode == THROUGHPUT
+			&& chosen == current
+			&& elapsed > 0) {
+		double achieved = length / elapsed;
+		if(achieved < target
+				&& current > compression::MIN_LEVEL)
+			--current;
+		else if(achieved > 2 * target
+				&& current < level)
+			++current;
+	}
+	return true;
+}
+
+/*
+ * Returns a compression policy's uncompressed byte count
+ */
+unsigned long long compression_policy::get_bytes_in(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return bytes_in;
+}
+
+/*
+ * Returns a compression policy's compressed byte count
+ */
+unsigned long long compression_policy::get_bytes_out(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return bytes_out;
+}
+
+/*
+ * Returns a compression policy's deflated chunk count
+ */
+unsigned long long compression_policy::get_count(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return count;
+}
+
+/*
+ * Returns a compression policy's achieved ratio
+ */
+double compression_policy::get_ratio(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return bytes_in ? (double) bytes_out / bytes_in : 0;
+}
+
+/*
+ * Returns a compression policy's time spent deflating
+ */
+double compression_policy::get_time(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	return time;
+}
+
+/*
+ * Clear a compression policy's statistics
+ */
+void compression_policy::reset(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	count = 0;
+	bytes_in = 0;
+	bytes_out = 0;
+	time = 0;
+	current = level;
+}
+
+/*
+ * Sets a compression policy's level
+ */
+void compression_policy::set_level(int level) {
+
+	// check level
+	if(level < 0
+			|| level > compression::MAX_LEVEL)
+		throw std::out_of_range("level out-of-range");
+	std::lock_guard<std::mutex> guard(lock);
+	this->level = level;
+	current = level;
+}
+
+/*
+ * Returns a string representation of a compression policy
+ */
+std::string compression_policy::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << "Mode: ";
+	switch(mode) {
+		case LEVEL: ss << "LEVEL";
+			break;
+		case THROUGHPUT: ss << "THROUGHPUT";
+			break;
+		case ADAPTIVE: ss << "ADAPTIVE";
+			break;
+		default: ss << "UNKNOWN";
+			break;
+	}
+	ss << ", Level: " << level << ", Chunks: " << get_count() << ", Ratio: " << get_ratio() << ", Time: " << get_time() << "s";
+	return ss.str();
+}
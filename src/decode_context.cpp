@@ -0,0 +1,121 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <sstream>
+#include "../include/compression.h"
+#include "../include/decode_context.h"
+
+/*
+ * Decode context constructor
+ */
+decode_context::decode_context(void) : initialized(false), count(0), bytes_in(0), bytes_out(0) {
+	memset(&inflater, 0, sizeof(inflater));
+}
+
+/*
+ * Decode context destructor
+ */
+decode_context::~decode_context(void) {
+	if(initialized)
+		inflateEnd(&inflater);
+}
+
+/*
+ * Returns the calling thread's decode context
+ */
+decode_context &decode_context::get_local(void) {
+	static thread_local decode_context context;
+	return context;
+}
+
+/*
+ * Inflate a char buffer in place, reusing a decode context's inflate stream and output buffer
+ */
+bool decode_context::inflate(std::vector<char> &data) {
+	int ret;
+	unsigned int total = 0;
+
+	// initialize zlib structure once, resetting it for each later chunk
+	if(!initialized) {
+		if(inflateInit(&inflater) != Z_OK)
+			return false;
+		initialized = true;
+	} else if(inflateReset(&inflater) != Z_OK)
+		return false;
+
+	// inflate into the whole of the output buffer, growing it as needed
+	buffer.resize(buffer.capacity());
+	inflater.next_in = (Bytef *) data.data();
+	inflater.avail_in = data.size();
+	do {
+		if(total == buffer.size())
+			buffer.resize(buffer.size() < compression::SEG_SIZE ? compression::SEG_SIZE : (buffer.size() * 2));
+		inflater.next_out = (Bytef *) buffer.data() + total;
+		inflater.avail_out = buffer.size() - total;
+		ret = ::inflate(&inflater, Z_NO_FLUSH);
+		total = buffer.size() - inflater.avail_out;
+	} while(ret == Z_OK);
+
+	// check for errors
+	if(ret != Z_STREAM_END)
+		return false;
+
+	// exchange buffers, keeping the compressed data's buffer for the next chunk
+	++count;
+	bytes_in += data.size();
+	bytes_out += total;
+	buffer.resize(total);
+	data.swap(buffer);
+	return true;
+}
+
+/*
+ * Release a decode context's buffers and inflate stream
+ */
+void decode_context::release(void) {
+	if(initialized)
+		inflateEnd(&inflater);
+	memset(&inflater, 0, sizeof(inflater));
+	initialized = false;
+	std::vector<char>().swap(buffer);
+	std::vector<char>().swap(raw);
+	stream = byte_stream();
+}
+
+/*
+ * Clear a decode context's statistics
+ */
+void decode_context::reset(void) {
+	count = 0;
+	bytes_in = 0;
+	bytes_out = 0;
+}
+
+/*
+ * Returns a string representation of a decode context
+ */
+std::string decode_context::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << "Chunks: " << count << ", In: " << bytes_in << ", Out: " << bytes_out << ", Buffered: "
+			<< (buffer.capacity() + raw.capacity() + stream.size());
+	return ss.str();
+}
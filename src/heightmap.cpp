@@ -0,0 +1,219 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "../include/chunk_section.h"
+#include "../include/heightmap.h"
+#include "../include/packed_array.h"
+#include "../include/tag/compound_tag.h"
+#include "../include/tag/int_array_tag.h"
+#include "../include/tag/long_array_tag.h"
+
+/*
+ * Compute a chunk's height maps of the given types from its section block data
+ */
+void heightmap::compute(const chunk_tag &tag, unsigned int types, int (&heights)[TYPE_COUNT][region_dim::BLOCK_COUNT]) {
+	int ids[region_dim::SECTION_BLOCK_COUNT];
+	std::vector<chunk_section> sections;
+	unsigned int active = 0, remaining[TYPE_COUNT];
+	const unsigned char *flags = get_flags();
+	unsigned char open[TYPE_COUNT][region_dim::BLOCK_COUNT];
+	const unsigned char masks[TYPE_COUNT] = { FLAG_OPAQUE, FLAG_SOLID | FLAG_FLUID, FLAG_SOLID, FLAG_NON_AIR };
+
+	// palette sections would read as all air, resolving every column to 0
+	if(chunk_section::has_palette(tag))
+		throw std::runtime_error("Unsupported chunk section format");
+
+	// every column starts unresolved, at height 0
+	memset(heights, 0, sizeof(heights));
+	for(unsigned int i = 0; i < TYPE_COUNT; ++i)
+		if(types & (1 << i)) {
+			memset(open[i], 1, sizeof(open[i]));
+			remaining[i] = region_dim::BLOCK_COUNT;
+			active |= (1 << i);
+		}
+
+	// scan sections top-down, stopping once every column of every type is resolved
+	chunk_section::get_sections(tag, sections);
+	for(int i = sections.size() - 1; (i >= 0) && active; --i) {
+
+		// all-air sections cannot resolve any column
+		if(sections.at(i).empty())
+			continue;
+		sections.at(i).get_blocks(ids);
+
+		// scan one 16 x 16 layer at a time, top-down
+		for(int b_y = region_dim::SECTION_HEIGHT - 1; (b_y >= 0) && active; --b_y) {
+			unsigned char layer[region_dim::BLOCK_COUNT];
+			const int *layer_ids = ids + b_y * region_dim::BLOCK_COUNT;
+			int height = sections.at(i).get_y() * (int) region_dim::SECTION_HEIGHT + b_y + 1;
+
+			// classify the layer once for all types
+			for(unsigned int c = 0; c < region_dim::BLOCK_COUNT; ++c)
+				layer[c] = flags[layer_ids[c]];
+
+			// resolve open columns that hit a matching block (branch-free, so it vectorizes)
+			for(unsigned int t = 0; t < TYPE_COUNT; ++t) {
+				unsigned int hits = 0;
+
+				if(!(active & (1 << t)))
+					continue;
+				for(unsigned int c = 0; c < region_dim::BLOCK_COUNT; ++c) {
+					unsigned char hit = open[t][c] & ((layer[c] & masks[t]) != 0);
+					heights[t][c] = hit ? height : heights[t][c];
+					open[t][c] &= !hit;
+					hits += hit;
+				}
+				remaining[t] -= hits;
+				if(!remaining[t])
+					active &= ~(1 << t);
+			}
+		}
+	}
+}
+
+/*
+ * Recompute a chunk's height maps of the given types, writing them back into the chunk
+ */
+void heightmap::generate(chunk_tag &tag, unsigned int types) {
+	generic_tag *height_maps = NULL;
+	int heights[TYPE_COUNT][region_dim::BLOCK_COUNT];
+
+	// compute before taking the level, so an unsupported chunk is left unmodified
+	compute(tag, types, heights);
+	compound_tag &level = tag.get_level_tag();
+	for(unsigned int i = 0; i < TYPE_COUNT; ++i) {
+		generic_tag *height = NULL;
+		std::string name = type_to_string((TYPE) (1 << i));
+
+		// skip types not requested
+		if(!(types & (1 << i)))
+			continue;
+
+		// legacy height maps are int arrays under the level tag
+		if((1 << i) == HEIGHT_MAP) {
+			std::vector<int> value(heights[i], heights[i] + region_dim::BLOCK_COUNT);
+			height = level.find(name);
+			if(!height) {
+				height = new int_array_tag(name);
+				level.push_back(height);
+			} else if(height->get_type() != generic_tag::INT_ARRAY)
+				throw std::runtime_error("Malformed height map");
+			static_cast<int_array_tag *>(height)->set_value(value);
+			continue;
+		}
+
+		// newer height maps are packed long arrays under "Heightmaps", which chunks decoded here do not normally carry
+		if(!height_maps) {
+			height_maps = level.find("Heightmaps");
+			if(!height_maps)
+				continue;
+			if(height_maps->get_type() != generic_tag::COMPOUND)
+				throw std::runtime_error("Malformed height map");
+		}
+		height = static_cast<compound_tag *>(height_maps)->find(name);
+		if(!height) {
+			height = new long_array_tag(name);
+			static_cast<compound_tag *>(height_maps)->push_back(height);
+		} else if(height->get_type() != generic_tag::LONG_ARRAY)
+			throw std::runtime_error("Malformed height map");
+
+		// keep an existing array's layout, otherwise use the padded (1.16+) layout
+		bool spanning = false;
+		std::vector<long> &value = static_cast<long_array_tag *>(height)->get_value();
+		if(packed_array::get_width(value, region_dim::BLOCK_COUNT, spanning) != PACKED_WIDTH)
+			spanning = false;
+		packed_array::pack(heights[i], region_dim::BLOCK_COUNT, PACKED_WIDTH, spanning, value);
+	}
+}
+
+/*
+ * Recompute the height maps of the given types for every filled chunk in a region
+ */
+void heightmap::generate(region &reg, unsigned int types, parallel::POLICY policy) {
+
+	// each chunk is rewritten independently, so chunks can be split across workers
+	parallel::for_each(0, region_dim::CHUNK_COUNT, [&](unsigned int pos) {
+		if(reg.is_filled(pos)
+				&& !chunk_section::has_palette(reg.get_tag_at(pos)))
+			generate(reg.get_tag_at(pos), types);
+	}, policy);
+}
+
+/*
+ * Returns the block classification flags, indexed by block id
+ */
+const unsigned char *heightmap::get_flags(void) {
+
+	// built once, on first use
+	static const std::vector<unsigned char> flags = [](void) {
+
+		// see-through, walk-through blocks (plants, rails, torches, redstone, signs, carpets, ...)
+		const int passable[] = { 6, 27, 28, 31, 32, 37, 38, 39, 40, 50, 51, 55, 59, 63, 65, 66, 68, 69, 70, 72, 75, 76, 77, 78, 83,
+				90, 93, 94, 104, 105, 106, 111, 115, 119, 131, 132, 141, 142, 143, 147, 148, 149, 150, 157, 171, 175, 176, 177, 207 };
+
+		// see-through, solid blocks (glass, panes, fences, doors, chests, ...)
+		const int transparent[] = { 20, 26, 34, 54, 64, 71, 81, 85, 92, 95, 96, 101, 102, 107, 113, 117, 118, 122, 130, 138, 139, 140,
+				144, 145, 146, 151, 154, 160, 165, 166, 167, 178, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197 };
+
+		// light-dimming, walk-through blocks (cobwebs)
+		const int dimming[] = { 30 };
+
+		// fluids (water and lava)
+		const int fluids[] = { 8, 9, 10, 11 };
+
+		// everything else is an opaque, solid block
+		std::vector<unsigned char> value(region_dim::SECTION_BLOCK_COUNT, FLAG_NON_AIR | FLAG_OPAQUE | FLAG_SOLID);
+		value[0] = 0;
+		for(unsigned int i = 0; i < sizeof(passable) / sizeof(*passable); ++i)
+			value[passable[i]] = FLAG_NON_AIR;
+		for(unsigned int i = 0; i < sizeof(transparent) / sizeof(*transparent); ++i)
+			value[transparent[i]] = FLAG_NON_AIR | FLAG_SOLID;
+		for(unsigned int i = 0; i < sizeof(dimming) / sizeof(*dimming); ++i)
+			value[dimming[i]] = FLAG_NON_AIR | FLAG_OPAQUE;
+		for(unsigned int i = 0; i < sizeof(fluids) / sizeof(*fluids); ++i)
+			value[fluids[i]] = FLAG_NON_AIR | FLAG_OPAQUE | FLAG_FLUID;
+		return value;
+	}();
+	return flags.data();
+}
+
+/*
+ * Return the tag name of a height map type
+ */
+std::string heightmap::type_to_string(TYPE type) {
+	std::string name;
+
+	// form tag name
+	switch(type) {
+		case HEIGHT_MAP: name = "HeightMap";
+			break;
+		case MOTION_BLOCKING: name = "MOTION_BLOCKING";
+			break;
+		case OCEAN_FLOOR: name = "OCEAN_FLOOR";
+			break;
+		case WORLD_SURFACE: name = "WORLD_SURFACE";
+			break;
+		default:
+			throw std::runtime_error("Unknown height map type");
+	}
+	return name;
+}
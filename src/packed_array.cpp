@@ -0,0 +1,112 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include "../include/packed_array.h"
+
+/*
+ * Returns the entry width (in bits) of a packed array holding a given number of entries
+ */
+unsigned int packed_array::get_width(const std::vector<long> &data, unsigned int count, bool &spanning) {
+	unsigned long long bits = data.size() * 64ULL;
+
+	// check for entries spanning long boundaries (pre-1.16)
+	spanning = false;
+	if(!count
+			|| data.empty())
+		return 0;
+	if(!(bits % count)
+			&& (bits / count) <= 32) {
+		spanning = true;
+		return bits / count;
+	}
+
+	// check for entries padded to long boundaries (1.16+)
+	for(unsigned int width = 1; width <= 32; ++width) {
+		unsigned int per_long = 64 / width;
+		if(((count + per_long - 1) / per_long) == data.size())
+			return width;
+	}
+	return 0;
+}
+
+/*
+ * Pack a given number of entries into a packed array of a given entry width
+ */
+void packed_array::pack(const int *values, unsigned int count, unsigned int width, bool spanning, std::vector<long> &data) {
+	unsigned long long mask;
+
+	// check for a valid width
+	if(!width
+			|| width > 32)
+		throw std::out_of_range("width out-of-range");
+	mask = (1ULL << width) - 1;
+
+	// pack entries
+	data.clear();
+	if(spanning) {
+		data.resize(((unsigned long long) count * width + 63) / 64, 0);
+		for(unsigned int i = 0; i < count; ++i) {
+			unsigned long long bit = (unsigned long long) i * width, value = values[i] & mask;
+			unsigned int index = bit / 64, shift = bit % 64;
+			data[index] |= (long) (value << shift);
+
+			// push the remaining bits into the next long
+			if(shift + width > 64)
+				data[index + 1] |= (long) (value >> (64 - shift));
+		}
+	} else {
+		unsigned int per_long = 64 / width;
+		data.resize((count + per_long - 1) / per_long, 0);
+		for(unsigned int i = 0; i < count; ++i)
+			data[i / per_long] |= (long) ((values[i] & mask) << ((i % per_long) * width));
+	}
+}
+
+/*
+ * Unpack a given number of entries from a packed array
+ */
+void packed_array::unpack(const std::vector<long> &data, unsigned int count, int *values) {
+	bool spanning;
+	unsigned int width = get_width(data, count, spanning);
+	unsigned long long mask;
+
+	// check for a known layout
+	if(!width)
+		throw std::runtime_error("Malformed packed array");
+	mask = (1ULL << width) - 1;
+
+	// unpack entries
+	if(spanning)
+		for(unsigned int i = 0; i < count; ++i) {
+			unsigned long long bit = (unsigned long long) i * width;
+			unsigned int index = bit / 64, shift = bit % 64;
+			unsigned long long value = (unsigned long long) data[index] >> shift;
+
+			// pull in the remaining bits from the next long
+			if(shift + width > 64)
+				value |= (unsigned long long) data[index + 1] << (64 - shift);
+			values[i] = value & mask;
+		}
+	else {
+		unsigned int per_long = 64 / width;
+		for(unsigned int i = 0; i < count; ++i)
+			values[i] = ((unsigned long long) data[i / per_long] >> ((i % per_long) * width)) & mask;
+	}
+}
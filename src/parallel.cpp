@@ -0,0 +1,88 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../include/parallel.h"
+
+/*
+ * Invoke a function for each index in [begin, end) using a given policy
+ */
+void parallel::for_each(unsigned int begin, unsigned int end, const std::function<void(unsigned int)> &func, POLICY policy) {
+	for_each_worker(begin, end, [&](unsigned int index, unsigned int worker) { func(index); }, policy);
+}
+
+/*
+ * Invoke a function for each index in [begin, end), along with the index of the worker calling it, using a given policy
+ */
+void parallel::for_each_worker(unsigned int begin, unsigned int end, const std::function<void(unsigned int, unsigned int)> &func,
+		POLICY policy) {
+	std::mutex lock;
+	std::exception_ptr error;
+	std::vector<std::thread> workers;
+	std::atomic<unsigned int> next(begin);
+	std::atomic<bool> failed(false);
+	unsigned int count;
+
+	// run inline when parallelism would not help
+	if(begin >= end)
+		return;
+	count = get_thread_count();
+	if(end - begin < count)
+		count = end - begin;
+	if(policy == SEQUENTIAL
+			|| count <= 1) {
+		for(unsigned int i = begin; i < end; ++i)
+			func(i, 0);
+		return;
+	}
+
+	// workers pull indices from a shared counter, so uneven work balances itself
+	for(unsigned int i = 0; i < count; ++i)
+		workers.push_back(std::thread([&, i](void) {
+			unsigned int index;
+
+			try {
+				while(!failed && ((index = next++) < end))
+					func(index, i);
+			} catch(...) {
+				std::lock_guard<std::mutex> guard(lock);
+				if(!error)
+					error = std::current_exception();
+				failed = true;
+			}
+		}));
+	for(unsigned int i = 0; i < workers.size(); ++i)
+		workers.at(i).join();
+
+	// forward the first failure to the caller
+	if(error)
+		std::rethrow_exception(error);
+}
+
+/*
+ * Returns the number of worker threads used by the parallel policy
+ */
+unsigned int parallel::get_thread_count(void) {
+	unsigned int count = std::thread::hardware_concurrency();
+	return count ? count : 1;
+}
@@ -19,6 +19,7 @@
 
 #include <sstream>
 #include <stdexcept>
+#include "../include/heightmap.h"
 #include "../include/region.h"
 #include "../include/tag/byte_tag.h"
 #include "../include/tag/byte_array_tag.h"
@@ -92,6 +93,19 @@ bool region::operator==(const region &other) {
 	return true;
 }
 
+/*
+ * Clear a region's header and chunks
+ */
+void region::clear(void) {
+
+	// reset attributes
+	header = region_header();
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+		tags[i].clear();
+	x = 0;
+	z = 0;
+}
+
 /*
  * Generate a new region
  */
@@ -112,9 +126,6 @@ void region::generate(int x, int z, region &reg) {
  * Generate a new chunk in a region
  */
 void region::generate_chunk(unsigned int x, unsigned int z, region &reg) {
-	unsigned char count;
-	unsigned int length, offset;
-	unsigned int pos = region_dim::HEADER_OFFSET;
 	unsigned int index = z * region_dim::CHUNK_WIDTH + x;
 
 	// check for valid index
@@ -160,19 +171,76 @@ void region::generate_chunk(unsigned int x, unsigned int z, region &reg) {
 	level->push_back(sections);
 	reg.get_tag_at(index).get_root_tag().push_back(level);
 
-	// update header to reflect changes
-	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
+	// fill in the (flat) height map of the empty chunk
+	heightmap::generate(reg.get_tag_at(index), heightmap::HEIGHT_MAP);
 
-		// skip over unfilled chunks
-		if(!reg.is_filled(i)
-				&& i != index)
-			continue;
-		length = reg.get_tag_at(i).get_data().size();
-		count = (length / region_dim::SECTOR_SIZE) + 1;
-		offset = pos / region_dim::SECTOR_SIZE;
-		reg.get_header().set_info_at(i, chunk_info((offset << 8) | count, length, chunk_info::ZLIB, 0));
-		pos += count * region_dim::SECTOR_SIZE;
+	// mark the chunk filled, leaving its layout to the writer
+	reg.set_filled(index);
+}
+
+/*
+ * Generate new chunks in a region at every index, as copies of a given prototype chunk
+ */
+void region::generate_chunks(chunk_tag &prototype, region &reg, parallel::POLICY policy) {
+	std::vector<unsigned int> indices;
+
+	// fill every index
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+		indices.push_back(i);
+	generate_chunks(prototype, indices, reg, policy);
+}
+
+/*
+ * Generate new chunks in a region at given indices, as copies of a given prototype chunk
+ */
+void region::generate_chunks(chunk_tag &prototype, const std::vector<unsigned int> &indices, region &reg,
+		parallel::POLICY policy) {
+	chunk_tag copy;
+	chunk_tag *source = &prototype;
+	std::vector<bool> seen(region_dim::CHUNK_COUNT, false);
+
+	// check for valid indices (duplicates would be copied into concurrently)
+	for(unsigned int i = 0; i < indices.size(); ++i) {
+		if(indices.at(i) >= region_dim::CHUNK_COUNT)
+			throw std::out_of_range("index out-of-range");
+		if(seen.at(indices.at(i)))
+			throw std::runtime_error("Duplicate chunk index");
+		seen.at(indices.at(i)) = true;
 	}
+
+	// copy from a copy of a prototype held by one of the target chunks, since those are replaced
+	if(source >= reg.tags
+			&& source < reg.tags + region_dim::CHUNK_COUNT
+			&& seen.at(source - reg.tags)) {
+		copy.copy(prototype);
+		source = &copy;
+	}
+
+	// copy the prototype into each index independently, so copies can be split across workers
+	parallel::for_each(0, indices.size(), [&](unsigned int i) {
+		unsigned int index = indices.at(i);
+		chunk_tag &tag = reg.get_tag_at(index);
+		generic_tag *x_pos, *z_pos;
+
+		// replace the old chunk with a copy of the prototype
+		tag.copy(*source);
+		tag.set_modified(true);
+		compound_tag &level = tag.get_level_tag();
+		x_pos = level.find("xPos");
+		z_pos = level.find("zPos");
+		if(x_pos
+				&& x_pos->get_type() == generic_tag::INT)
+			static_cast<int_tag *>(x_pos)->set_value(reg.get_x() * (int) region_dim::CHUNK_WIDTH
+					+ (int) (index % region_dim::CHUNK_WIDTH));
+		if(z_pos
+				&& z_pos->get_type() == generic_tag::INT)
+			static_cast<int_tag *>(z_pos)->set_value(reg.get_z() * (int) region_dim::CHUNK_WIDTH
+					+ (int) (index / region_dim::CHUNK_WIDTH));
+	}, policy);
+
+	// mark the chunks filled, leaving their layout to the writer
+	for(unsigned int i = 0; i < indices.size(); ++i)
+		reg.set_filled(indices.at(i));
 }
 
 /*
@@ -197,6 +265,16 @@ bool region::is_filled(unsigned int index) {
 	return !header.get_info_at(index).empty();
 }
 
+/*
+ * Marks a region's chunk filled
+ */
+void region::set_filled(unsigned int index) {
+
+	// any non-zero offset marks a chunk filled; the writer lays out every chunk when writing
+	header.set_info_at(index, chunk_info(((region_dim::HEADER_OFFSET / region_dim::SECTOR_SIZE) << 8) | 1, 0, chunk_info::ZLIB,
+			0));
+}
+
 /*
  * Sets a region's tags
  */
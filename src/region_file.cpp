@@ -17,7 +17,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <fstream>
 #include <sstream>
+#include <stdexcept>
+#include "../include/region_dim.h"
 #include "../include/region_file.h"
 
 /*
@@ -67,6 +70,21 @@ void region_file::convert_endian(std::vector<char> &data) {
 	data = rev;
 }
 
+/*
+ * Returns the path of a chunk's external (.mcc) file, alongside a given region file
+ */
+std::string region_file::get_chunk_path(const std::string &path, unsigned int x, unsigned int z) {
+	int reg_x, reg_z;
+	std::stringstream ss;
+
+	// external files are named by world chunk coord
+	if(!is_region_file(path, reg_x, reg_z))
+		throw std::runtime_error("Malformated region filename");
+	ss << path.substr(0, path.find_last_of('/') + 1) << "c." << (reg_x * (int) region_dim::CHUNK_WIDTH + (int) x) << "."
+			<< (reg_z * (int) region_dim::CHUNK_WIDTH + (int) z) << ".mcc";
+	return ss.str();
+}
+
 /*
  * Returns true if a specified path is a region file
  */
@@ -86,6 +104,26 @@ bool region_file::is_region_file(const std::string &path, int &x, int &z) {
 	return true;
 }
 
+/*
+ * Reads a chunk's compressed data from its external (.mcc) file
+ */
+void region_file::read_external(unsigned int x, unsigned int z, std::vector<char> &data) {
+	std::streamoff length;
+
+	// attempt to open file
+	std::ifstream file(get_chunk_path(x, z).c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		throw std::runtime_error("Failed to open external chunk file");
+
+	// read the whole file straight into data
+	length = file.tellg();
+	data.resize(length, 0);
+	file.seekg(0, std::ios::beg);
+	if(length
+			&& !file.read(&data[0], length))
+		throw std::runtime_error("Failed to read external chunk data");
+}
+
 /*
  * Returns a string representation of a region file
  */
@@ -98,3 +136,19 @@ std::string region_file::to_string(void) {
 	ss << reg.to_string();
 	return ss.str();
 }
+
+/*
+ * Writes a chunk's compressed data to its external (.mcc) file
+ */
+void region_file::write_external(unsigned int x, unsigned int z, const std::vector<char> &data) {
+
+	// attempt to open file
+	std::ofstream file(get_chunk_path(x, z).c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+	if(!file.is_open())
+		throw std::runtime_error("Failed to open external chunk file");
+
+	// write data straight from its buffer
+	if(!file.write(data.data(), data.size())
+			|| !file.flush())
+		throw std::runtime_error("Failed to write external chunk data");
+}
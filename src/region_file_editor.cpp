@@ -0,0 +1,760 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/chunk_info.h"
+#include "../include/chunk_tag.h"
+#include "../include/compression.h"
+#include "../include/region_dim.h"
+#include "../include/region_file_editor.h"
+#include "../include/region_file_reader.h"
+#include "../include/region_header.h"
+
+/*
+ * Region file editor assignment operator
+ */
+region_file_editor &region_file_editor::operator=(const region_file_editor &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	path = other.path;
+	reg = other.reg;
+	end = other.end;
+	used = other.used;
+	return *this;
+}
+
+/*
+ * Region file editor equals operator
+ */
+bool region_file_editor::operator==(const region_file_editor &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return path == other.path
+			&& reg == other.reg;
+}
+
+/*
+ * Allocate a run of sectors for a chunk at a given index
+ */
+unsigned int region_file_editor::allocate(unsigned int pos, unsigned int count) {
+	unsigned int sector;
+	chunk_info &info = reg.get_header().get_info_at(pos);
+	unsigned int old = info.get_offset() >> 8, old_count = info.get_offset() & 0xff;
+
+	// rewrite in place, freeing any sectors no longer needed
+	if(!info.empty()
+			&& count <= old_count) {
+		mark(old + count, old_count - count, false);
+		return old;
+	}
+
+	// find the first free run, or the free run at the end of the file
+	sector = find_run(count, false);
+
+	// hold the new run, then release the old one
+	mark(sector, count, true);
+	if(!info.empty())
+		mark(old, old_count, false);
+	return sector;
+}
+
+/*
+ * Closes a region file editor's file
+ */
+void region_file_editor::close(void) {
+	file.close();
+}
+
+/*
+ * Compact a region file editor's file in place
+ */
+unsigned int region_file_editor::compact(void) {
+	unsigned int reclaimed;
+	std::string temp = path + ".tmp";
+
+	// write the compacted file alongside, then swap it in
+	reclaimed = compact(temp);
+	file.close();
+	if(std::rename(temp.c_str(), path.c_str())) {
+		std::remove(temp.c_str());
+		throw std::runtime_error("Failed to replace region file");
+	}
+
+	// sync the rename, then reopen
+	sync_directory();
+	open();
+	return reclaimed;
+}
+
+/*
+ * Write a compacted copy of a region file editor's file to a given path
+ */
+unsigned int region_file_editor::compact(const std::string &destination) {
+	int fd;
+	char type;
+	region_header header;
+	unsigned int count, sector = region_dim::HEADER_OFFSET / region_dim::SECTOR_SIZE, start = sector;
+	std::string directory = destination.substr(0, destination.find_last_of('/') + 1);
+	std::vector<char> data, record, buffer, header_data;
+	std::vector<std::string> copied;
+	std::vector<std::pair<unsigned int, unsigned int>> order;
+
+	// truncating the editor's own file would destroy the chunks being copied
+	if(is_same_file(destination, path))
+		throw std::runtime_error("Cannot compact a region file onto itself");
+
+	// order chunks by their current sector, keeping their relative layout
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+		if(!reg.get_header().get_info_at(i).empty())
+			order.push_back(std::make_pair(reg.get_header().get_info_at(i).get_offset() >> 8, i));
+	std::sort(order.begin(), order.end());
+
+	// attempt to open output file
+	fd = ::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		throw std::runtime_error("Failed to open output file");
+
+	try {
+
+		// pack chunk records back to back, writing them in large runs
+		for(unsigned int i = 0; i < order.size(); ++i) {
+			unsigned int pos = order.at(i).second;
+			read_record(pos, data, type);
+
+			// external chunks keep their stub, so copy their file next to the destination (unless already there)
+			if((unsigned char) type & chunk_info::EXTERNAL) {
+				std::string source_path = get_chunk_path(pos % region_dim::CHUNK_WIDTH, pos / region_dim::CHUNK_WIDTH),
+						copy_path = directory + source_path.substr(source_path.find_last_of('/') + 1);
+				if(!is_same_file(copy_path, source_path)) {
+					std::vector<char> external;
+					read_external(pos % region_dim::CHUNK_WIDTH, pos / region_dim::CHUNK_WIDTH, external);
+					std::ofstream copy(copy_path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+					copied.push_back(copy_path);
+					if(!copy.is_open()
+							|| !copy.write(external.data(), external.size())
+							|| !copy.flush())
+						throw std::runtime_error("Failed to write external chunk data");
+				}
+			}
+			count = form_record(data, type, record);
+			buffer.insert(buffer.end(), record.begin(), record.end());
+			header.set_info_at(pos, chunk_info((sector << 8) | count, data.size(), type,
+					reg.get_header().get_info_at(pos).get_modified()));
+			sector += count;
+			if(buffer.size() >= WRITE_SIZE
+					|| i + 1 == order.size()) {
+				write_fully(fd, buffer, (unsigned long long) start * region_dim::SECTOR_SIZE);
+				start = sector;
+				buffer.clear();
+			}
+		}
+
+		// write the header last, then sync
+		header_data = header.get_data();
+		write_fully(fd, header_data, 0);
+		if(::ftruncate(fd, (off_t) sector * region_dim::SECTOR_SIZE)
+				|| ::fsync(fd))
+			throw std::runtime_error("Failed to write region file");
+	} catch(...) {
+		::close(fd);
+		std::remove(destination.c_str());
+		for(unsigned int i = 0; i < copied.size(); ++i)
+			std::remove(copied.at(i).c_str());
+		throw;
+	}
+	::close(fd);
+	return end > sector ? end - sector : 0;
+}
+
+/*
+ * Copy a chunk's compressed data verbatim from a given source region file into a region file editor
+ */
+void region_file_editor::copy_chunk(region_file_editor &source, unsigned int src_x, unsigned int src_z, unsigned int x,
+		unsigned int z, bool validate) {
+	char type;
+	std::vector<char> data;
+
+	// check coordinates
+	if(src_z * region_dim::CHUNK_WIDTH + src_x >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+
+	// copying a missing chunk removes it
+	source.read_chunk_data(src_x, src_z, data, type);
+	if(data.empty()) {
+		remove_chunk(x, z);
+		return;
+	}
+
+	// optionally check that the chunk decodes, on a copy of its data
+	if(validate) {
+		chunk_tag tag;
+		std::vector<char> decoded = data;
+		region_file_reader::decode_chunk(decoded, type, NULL, tag);
+	}
+	write_chunk_data(x, z, data, type, source.get_region().get_header().get_info_at(src_z * region_dim::CHUNK_WIDTH + src_x)
+			.get_modified());
+}
+
+/*
+ * Form a chunk's sector-aligned record, returning its sector count
+ */
+unsigned int region_file_editor::form_record(const std::vector<char> &data, char type, std::vector<char> &record) {
+	int length = (int) data.size();
+	unsigned int count = (data.size() + (sizeof(int) + sizeof(char)) + region_dim::SECTOR_SIZE - 1) / region_dim::SECTOR_SIZE;
+
+	// check size
+	if(count > region_dim::CHUNK_SECTOR_COUNT)
+		throw std::runtime_error("Chunk too large");
+
+	// form chunk header and data, padded out to a whole sector
+	convert_endian(length);
+	record.assign(count * region_dim::SECTOR_SIZE, 0);
+	std::memcpy(&record[0], &length, sizeof(length));
+	record.at(sizeof(length)) = type;
+	std::copy(data.begin(), data.end(), record.begin() + (sizeof(int) + sizeof(char)));
+	return count;
+}
+
+/*
+ * Find a free run of sectors
+ */
+unsigned int region_file_editor::find_run(unsigned int count, bool best) {
+	unsigned int run = 0, sector = end, length = 0;
+
+	// walk the bitmap, ending each run at a used sector
+	for(unsigned int i = region_dim::HEADER_OFFSET / region_dim::SECTOR_SIZE; i < end; ++i) {
+		if(!used.at(i)) {
+			++run;
+			continue;
+		}
+
+		// take the first run that fits, or the smallest
+		if(run >= count
+				&& (sector == end || run < length)) {
+			sector = i - run;
+			length = run;
+			if(!best)
+				break;
+		}
+		run = 0;
+	}
+
+	// otherwise extend the free run at the end of the file
+	if(sector == end)
+		sector -= run;
+	if(sector > region_dim::SECTOR_OFFSET_MAX)
+		throw std::runtime_error("Region file too large");
+	return sector;
+}
+
+/*
+ * Returns a region file editor's free sector count
+ */
+unsigned int region_file_editor::get_free_count(void) {
+	unsigned int count = 0;
+
+	// count sectors not held by the header or a chunk
+	for(unsigned int i = 0; i < end; ++i)
+		if(!used.at(i))
+			++count;
+	return count;
+}
+
+/*
+ * Returns true if a chunk at a given index is stored in an external file
+ */
+bool region_file_editor::is_external(unsigned int pos) {
+	char type = 0;
+	chunk_info &info = reg.get_header().get_info_at(pos);
+
+	// check the compression type stored after the chunk's length
+	if(info.empty()
+			|| !file.is_open())
+		return false;
+	file.clear();
+	file.seekg((unsigned long long) (info.get_offset() >> 8) * region_dim::SECTOR_SIZE + sizeof(int), std::ios::beg);
+	file.read(&type, sizeof(type));
+	return file.good()
+			&& ((unsigned char) type & chunk_info::EXTERNAL);
+}
+
+/*
+ * Returns true if two paths name the same file
+ */
+bool region_file_editor::is_same_file(const std::string &left, const std::string &right) {
+	struct stat left_status, right_status;
+
+	// compare identities, since different paths can name one file
+	if(left == right)
+		return true;
+	return !stat(left.c_str(), &left_status)
+			&& !stat(right.c_str(), &right_status)
+			&& left_status.st_dev == right_status.st_dev
+			&& left_status.st_ino == right_status.st_ino;
+}
+
+/*
+ * Mark a run of sectors as used or free
+ */
+void region_file_editor::mark(unsigned int sector, unsigned int count, bool value) {
+
+	// grow the bitmap to cover the run
+	if(sector + count > used.size())
+		used.resize(sector + count, false);
+	for(unsigned int i = sector; i < sector + count; ++i)
+		used.at(i) = value;
+	end = std::max(end, (unsigned int) used.size());
+}
+
+/*
+ * Opens a region file editor's file and reads its header
+ */
+void region_file_editor::open(void) {
+	std::vector<char> header_data(region_dim::HEADER_OFFSET, 0);
+
+	// attempt to open file, creating an empty region file if none exists
+	file.close();
+	file.clear();
+	file.open(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+	if(!file.is_open()) {
+		file.clear();
+		file.open(path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+		if(!file.is_open())
+			throw std::runtime_error("Failed to open output file");
+		file.write(header_data.data(), header_data.size());
+		file.close();
+		file.clear();
+		file.open(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+		if(!file.is_open())
+			throw std::runtime_error("Failed to open output file");
+	}
+
+	// read header
+	file.read(&header_data[0], header_data.size());
+	if(file.gcount() != (std::streamsize) header_data.size()) {
+		file.close();
+		throw std::runtime_error("Malformed region header");
+	}
+	reg.get_header().set_data(header_data);
+
+	// find the end of the file, rounded up to a whole sector
+	file.seekg(0, std::ios::end);
+	end = (unsigned int) (((unsigned long long) file.tellg() + region_dim::SECTOR_SIZE - 1) / region_dim::SECTOR_SIZE);
+
+	// build the sector bitmap from the header
+	used.assign(end, false);
+	mark(0, region_dim::HEADER_OFFSET / region_dim::SECTOR_SIZE, true);
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+		if(!reg.get_header().get_info_at(i).empty())
+			mark(reg.get_header().get_info_at(i).get_offset() >> 8, reg.get_header().get_info_at(i).get_offset() & 0xff, true);
+}
+
+/*
+ * Reads a chunk's compressed data and compression type, as stored
+ */
+void region_file_editor::read_chunk_data(unsigned int x, unsigned int z, std::vector<char> &data, char &type) {
+
+	// check coordinates
+	if(z * region_dim::CHUNK_WIDTH + x >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+
+	// oversized chunks are stored in their own file
+	read_record(z * region_dim::CHUNK_WIDTH + x, data, type);
+	if(!data.empty()
+			&& ((unsigned char) type & chunk_info::EXTERNAL)) {
+		type = (unsigned char) type & ~chunk_info::EXTERNAL;
+		read_external(x, z, data);
+	}
+}
+
+/*
+ * Reads a chunk's record at a given index, as stored
+ */
+void region_file_editor::read_record(unsigned int pos, std::vector<char> &data, char &type) {
+	int length;
+	unsigned long long extent;
+
+	// check coordinates
+	if(pos >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+
+	// skip empty chunks
+	data.clear();
+	type = chunk_info::ZLIB;
+	chunk_info &info = reg.get_header().get_info_at(pos);
+	if(info.empty())
+		return;
+
+	// read chunk length and compression type
+	if(!file.is_open())
+		throw std::runtime_error("Failed to read chunk data");
+	file.clear();
+	file.seekg((unsigned long long) (info.get_offset() >> 8) * region_dim::SECTOR_SIZE, std::ios::beg);
+	file.read(reinterpret_cast<char *>(&length), sizeof(length));
+	convert_endian(length);
+	file.read(&type, sizeof(type));
+	if(!file.good()
+			|| length <= 0)
+		throw std::runtime_error("Malformed chunk data");
+
+	// read chunk data, within the chunk's sectors
+	extent = (unsigned long long) (info.get_offset() & 0xff) * region_dim::SECTOR_SIZE - (sizeof(int) + sizeof(char));
+	data.resize(std::min((unsigned long long) length, extent), 0);
+	file.read(&data[0], data.size());
+	data.resize(file.gcount());
+}
+
+/*
+ * Removes a chunk from a region file editor's header
+ */
+void region_file_editor::remove_chunk(unsigned int x, unsigned int z) {
+	unsigned int pos = z * region_dim::CHUNK_WIDTH + x;
+
+	// check coordinates
+	if(pos >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+
+	// free sectors (and any external file) and clear header entries
+	bool external = is_external(pos);
+	chunk_info &info = reg.get_header().get_info_at(pos);
+	if(!info.empty())
+		mark(info.get_offset() >> 8, info.get_offset() & 0xff, false);
+	reg.get_header().set_info_at(pos, chunk_info(0, 0, chunk_info::ZLIB, 0));
+	write_header_at(pos);
+	if(external)
+		std::remove(get_chunk_path(x, z).c_str());
+}
+
+/*
+ * Returns a string representation of a region file editor
+ */
+std::string region_file_editor::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << region_file::to_string() << ", Sectors: " << end;
+	return ss.str();
+}
+
+/*
+ * Compresses and writes a single chunk
+ */
+void region_file_editor::write_chunk(unsigned int x, unsigned int z, chunk_tag &tag, unsigned int modified) {
+
+	// write unmodified chunks as read
+	if(tag.has_original()) {
+		write_chunk_data(x, z, tag.get_original(), tag.get_original_type(), modified);
+		return;
+	}
+
+	// compress chunk
+	std::vector<char> chunk_data = tag.get_data();
+	if(!compression::deflate_(chunk_data))
+		throw std::runtime_error("Failed to compress chunk");
+	write_chunk_data(x, z, chunk_data, chunk_info::ZLIB, modified);
+}
+
+/*
+ * Writes a batch of chunks, then publishes them with a single header write
+ */
+void region_file_editor::write_chunks(const std::vector<chunk_write> &writes) {
+	std::set<unsigned int> positions;
+	region_header header = reg.get_header();
+	unsigned int saved_end = end, next = 0, start = 0;
+	bool renamed = true;
+	std::vector<bool> saved = used, stale(writes.size(), false);
+	std::vector<std::pair<std::string, std::string>> staged;
+	std::vector<unsigned int> counts(writes.size(), 0), order;
+	std::vector<std::vector<char>> records(writes.size());
+	std::vector<std::pair<unsigned int, unsigned int>> placed;
+	std::vector<char> buffer, header_data;
+
+	// check coordinates
+	if(!file.is_open())
+		throw std::runtime_error("Failed to write chunk data");
+	for(unsigned int i = 0; i < writes.size(); ++i) {
+		unsigned int pos = writes.at(i).z * region_dim::CHUNK_WIDTH + writes.at(i).x;
+		if(pos >= region_dim::CHUNK_COUNT)
+			throw std::out_of_range("coordinates out-of-range");
+		if(!positions.insert(pos).second)
+			throw std::runtime_error("Duplicate chunk in batch");
+	}
+
+	try {
+
+		// form records, staging oversized chunks in synced temporary files, renamed into place once published
+		for(unsigned int i = 0; i < writes.size(); ++i) {
+			const chunk_write &write = writes.at(i);
+			unsigned int pos = write.z * region_dim::CHUNK_WIDTH + write.x;
+			char type = (unsigned char) write.type & ~chunk_info::EXTERNAL;
+			bool external = !write.remove
+					&& (write.data.size() + (sizeof(int) + sizeof(char)) + region_dim::SECTOR_SIZE - 1) / region_dim::SECTOR_SIZE
+					> region_dim::CHUNK_SECTOR_COUNT;
+
+			stale.at(i) = !external && is_external(pos);
+			if(write.remove) {
+				header.set_info_at(pos, chunk_info(0, 0, chunk_info::ZLIB, 0));
+				continue;
+			}
+			if(external) {
+				staged.push_back(std::make_pair(get_chunk_path(write.x, write.z) + ".tmp", get_chunk_path(write.x, write.z)));
+				write_synced(staged.back().first, write.data);
+				counts.at(i) = form_record(std::vector<char>(1, 0), type | chunk_info::EXTERNAL, records.at(i));
+				header.set_info_at(pos, chunk_info(0, 1, type | chunk_info::EXTERNAL, write.modified));
+			} else {
+				counts.at(i) = form_record(write.data, type, records.at(i));
+				header.set_info_at(pos, chunk_info(0, write.data.size(), type, write.modified));
+			}
+			order.push_back(i);
+		}
+
+		// place the largest chunks first, each into the smallest free run that fits, keeping replaced sectors held
+		std::stable_sort(order.begin(), order.end(), [&](unsigned int left, unsigned int right) {
+			return counts.at(left) > counts.at(right);
+		});
+		for(unsigned int i = 0; i < order.size(); ++i) {
+			unsigned int index = order.at(i), sector = find_run(counts.at(index), true);
+			chunk_info &info = header.get_info_at(writes.at(index).z * region_dim::CHUNK_WIDTH + writes.at(index).x);
+			mark(sector, counts.at(index), true);
+			info.set_offset(((unsigned long long) sector << 8) | counts.at(index));
+			placed.push_back(std::make_pair(sector, index));
+		}
+
+		// write records in ascending sector order, coalescing adjacent records into one write
+		std::sort(placed.begin(), placed.end());
+		for(unsigned int i = 0; i <= placed.size(); ++i) {
+			if(!buffer.empty()
+					&& (i == placed.size() || placed.at(i).first != next)) {
+				file.clear();
+				file.seekp((unsigned long long) start * region_dim::SECTOR_SIZE, std::ios::beg);
+				file.write(buffer.data(), buffer.size());
+				buffer.clear();
+			}
+			if(i == placed.size())
+				break;
+			if(buffer.empty())
+				start = placed.at(i).first;
+			buffer.insert(buffer.end(), records.at(placed.at(i).second).begin(), records.at(placed.at(i).second).end());
+			next = placed.at(i).first + counts.at(placed.at(i).second);
+		}
+
+		// make the chunks durable, then publish the header
+		sync();
+		header_data = header.get_data();
+		file.seekp(0, std::ios::beg);
+		file.write(header_data.data(), header_data.size());
+		sync();
+	} catch(...) {
+		used = saved;
+		end = saved_end;
+		for(unsigned int i = 0; i < staged.size(); ++i)
+			std::remove(staged.at(i).first.c_str());
+		throw;
+	}
+
+	// replace external files (keeping the old files until the header was published), then release replaced sectors
+	// and stale external files
+	for(unsigned int i = 0; i < staged.size(); ++i)
+		if(std::rename(staged.at(i).first.c_str(), staged.at(i).second.c_str())) {
+			std::remove(staged.at(i).first.c_str());
+			renamed = false;
+		}
+	if(!staged.empty())
+		sync_directory();
+	for(unsigned int i = 0; i < writes.size(); ++i) {
+		unsigned int pos = writes.at(i).z * region_dim::CHUNK_WIDTH + writes.at(i).x;
+		chunk_info &info = reg.get_header().get_info_at(pos);
+		if(!info.empty())
+			mark(info.get_offset() >> 8, info.get_offset() & 0xff, false);
+		if(stale.at(i))
+			std::remove(get_chunk_path(writes.at(i).x, writes.at(i).z).c_str());
+	}
+	for(std::set<unsigned int>::iterator iter = positions.begin(); iter != positions.end(); ++iter)
+		reg.get_header().set_info_at(*iter, header.get_info_at(*iter));
+	if(!renamed)
+		throw std::runtime_error("Failed to replace external chunk file");
+}
+
+/*
+ * Writes a chunk's compressed data and compression type, as given
+ */
+void region_file_editor::write_chunk_data(unsigned int x, unsigned int z, const std::vector<char> &data, char type,
+		unsigned int modified) {
+	unsigned int count, sector;
+	unsigned int pos = z * region_dim::CHUNK_WIDTH + x;
+	bool external = (data.size() + (sizeof(int) + sizeof(char)) + region_dim::SECTOR_SIZE - 1) / region_dim::SECTOR_SIZE
+			> region_dim::CHUNK_SECTOR_COUNT;
+	bool stale;
+	std::vector<char> record;
+
+	// check coordinates
+	if(pos >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+	if(!file.is_open())
+		throw std::runtime_error("Failed to write chunk data");
+	stale = !external && is_external(pos);
+
+	// oversized chunks go to their own file, leaving a one-sector stub
+	type = (unsigned char) type & ~chunk_info::EXTERNAL;
+	if(external) {
+		write_external(x, z, data);
+		count = form_record(std::vector<char>(1, 0), type | chunk_info::EXTERNAL, record);
+	} else
+		count = form_record(data, type, record);
+
+	// write chunk before its header entries
+	sector = allocate(pos, count);
+	file.clear();
+	file.seekp((unsigned long long) sector * region_dim::SECTOR_SIZE, std::ios::beg);
+	file.write(record.data(), record.size());
+	file.flush();
+	if(!file.good())
+		throw std::runtime_error("Failed to write chunk data");
+	reg.get_header().set_info_at(pos, chunk_info(((unsigned long long) sector << 8) | count, external ? 1 : data.size(),
+			external ? (type | chunk_info::EXTERNAL) : type, modified));
+	write_header_at(pos);
+
+	// remove any stale external file
+	if(stale)
+		std::remove(get_chunk_path(x, z).c_str());
+}
+
+/*
+ * Flush and sync a region file editor's file to disk
+ */
+void region_file_editor::sync(void) {
+	int fd;
+
+	// sync through a second descriptor, since syncing covers the whole file
+	file.flush();
+	if(!file.good())
+		throw std::runtime_error("Failed to write region file");
+	fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw std::runtime_error("Failed to sync region file");
+	if(::fsync(fd)) {
+		::close(fd);
+		throw std::runtime_error("Failed to sync region file");
+	}
+	::close(fd);
+}
+
+/*
+ * Sync the directory holding a region file editor's file, making renames within it durable
+ */
+void region_file_editor::sync_directory(void) {
+	int dir;
+	std::string directory = ".";
+
+	// sync the directory, where it can be opened
+	if(path.find_last_of('/') != std::string::npos)
+		directory = path.substr(0, path.find_last_of('/') + 1);
+	dir = ::open(directory.c_str(), O_RDONLY);
+	if(dir >= 0) {
+		::fsync(dir);
+		::close(dir);
+	}
+}
+
+/*
+ * Write a region file editor's header entries at a given index
+ */
+void region_file_editor::write_header_at(unsigned int pos) {
+	int value;
+	chunk_info &info = reg.get_header().get_info_at(pos);
+
+	// check if file is open
+	if(!file.is_open())
+		throw std::runtime_error("Failed to write header data");
+
+	// patch offset and timestamp entries
+	file.clear();
+	value = (int) info.get_offset();
+	convert_endian(value);
+	file.seekp(pos * sizeof(int), std::ios::beg);
+	file.write(reinterpret_cast<char *>(&value), sizeof(value));
+	value = (int) info.get_modified();
+	convert_endian(value);
+	file.seekp(region_dim::SECTOR_SIZE + pos * sizeof(int), std::ios::beg);
+	file.write(reinterpret_cast<char *>(&value), sizeof(value));
+	file.flush();
+	if(!file.good())
+		throw std::runtime_error("Failed to write header data");
+}
+
+/*
+ * Write data to a file descriptor at a given position, retrying short writes
+ */
+void region_file_editor::write_fully(int fd, const std::vector<char> &data, unsigned long long position) {
+	ssize_t result;
+	unsigned int done = 0;
+
+	// write until every byte lands
+	while(done < data.size()) {
+		result = ::pwrite(fd, data.data() + done, data.size() - done, (off_t) (position + done));
+		if(result < 0) {
+			if(errno == EINTR)
+				continue;
+			throw std::runtime_error("Failed to write region file");
+		}
+		done += result;
+	}
+}
+
+/*
+ * Write data to a new file at a given path, then sync it
+ */
+void region_file_editor::write_synced(const std::string &path, const std::vector<char> &data) {
+	int fd;
+
+	// attempt to open file
+	fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		throw std::runtime_error("Failed to open external chunk file");
+
+	// write and sync, removing the file on failure
+	try {
+		write_fully(fd, data, 0);
+		if(::fsync(fd))
+			throw std::runtime_error("Failed to write external chunk data");
+	} catch(...) {
+		::close(fd);
+		std::remove(path.c_str());
+		throw;
+	}
+	::close(fd);
+}
@@ -17,11 +17,14 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <sys/stat.h>
 #include <vector>
 #include "../include/chunk_info.h"
 #include "../include/chunk_tag.h"
-#include "../include/compression.h"
+#include "../include/packed_array.h"
 #include "../include/region_dim.h"
 #include "../include/region_file_reader.h"
 #include "../include/tag/byte_tag.h"
@@ -38,6 +41,7 @@
 #include "../include/tag/long_array_tag.h"
 #include "../include/tag/short_tag.h"
 #include "../include/tag/string_tag.h"
+#include "../include/world.h"
 
 /*
  * Region file reader assignment operator
@@ -51,6 +55,8 @@ region_file_reader &region_file_reader::operator=(const region_file_reader &othe
 	// assign attributes
 	path = other.path;
 	reg = other.reg;
+	filter = other.filter;
+	retain = other.retain;
 	return *this;
 }
 
@@ -68,6 +74,95 @@ bool region_file_reader::operator==(const region_file_reader &other) {
 			&& reg == other.reg;
 }
 
+/*
+ * Closes a region file reader's file
+ */
+void region_file_reader::close(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	file.close();
+	source = NULL;
+}
+
+/*
+ * Inflate and parse raw chunk data of a given compression type into a chunk tag, using a given decode context's buffers
+ */
+void region_file_reader::decode_chunk(std::vector<char> &data, char type, const std::set<std::string> *filter, chunk_tag &tag,
+		decode_context &context) {
+
+	// check for compression type (external chunks use the same types)
+	switch((unsigned char) type & ~chunk_info::EXTERNAL) {
+		case chunk_info::GZIP:
+			throw std::runtime_error("Unsupported compression type");
+			break;
+		case chunk_info::ZLIB:
+			if(context.inflate(data) == false)
+				throw std::runtime_error("Failed to uncompress chunk");
+			break;
+		default:
+			throw std::runtime_error("Unknown compression type");
+			break;
+	}
+
+	// use data to fill chunk tag, lending it to the context's stream rather than copying it
+	byte_stream &stream = context.get_stream();
+	stream.swap_buffer(data);
+	try {
+		parse_chunk_tag(stream, filter, tag);
+	} catch(...) {
+		stream.swap_buffer(data);
+		throw;
+	}
+	stream.swap_buffer(data);
+
+	// a freshly decoded chunk is unmodified
+	tag.set_modified(false);
+}
+
+/*
+ * Inflate and parse raw chunk data, as read by read_chunk_data, into a given chunk tag, using a given decode context's buffers
+ */
+void region_file_reader::decode_chunk_data(unsigned int x, unsigned int z, std::vector<char> &data, chunk_tag &tag,
+		decode_context &context) {
+	unsigned int pos = z * region_dim::CHUNK_WIDTH + x;
+
+	// check coordinates
+	if(pos >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+	if(data.empty())
+		return;
+
+	// keep a copy of the original data, since it is inflated in place, attaching it once the chunk is decoded
+	chunk_info &info = reg.get_header().get_info_at(pos);
+	std::vector<char> original;
+	if(retain)
+		original = data;
+	decode_chunk(data, info.get_type(), filter.empty() ? NULL : &filter, tag, context);
+	if(retain)
+		tag.set_original(original, info.get_type());
+}
+
+/*
+ * Invoke a callback with the chunk x, z coord of each non-empty section within a region
+ */
+void region_file_reader::for_each_section(const std::function<void(unsigned int, unsigned int, chunk_section &)> &func,
+		parallel::POLICY policy) {
+
+	// each chunk is visited independently, so chunks can be split across workers
+	parallel::for_each(0, region_dim::CHUNK_COUNT, [&](unsigned int pos) {
+		std::vector<chunk_section> sections;
+
+		// skip missing chunks
+		if(!reg.is_filled(pos))
+			return;
+
+		// visit each section, skipping those made entirely of air
+		chunk_section::get_sections(reg.get_tag_at(pos), sections);
+		for(unsigned int i = 0; i < sections.size(); ++i)
+			if(!sections.at(i).empty())
+				func(pos % region_dim::CHUNK_WIDTH, pos / region_dim::CHUNK_WIDTH, sections.at(i));
+	}, policy);
+}
+
 /*
  * Returns a region biome value at a given x, z & b coord
  */
@@ -82,12 +177,82 @@ char region_file_reader::get_biome_at(unsigned int x, unsigned int z, unsigned i
 		throw std::out_of_range("coordinates out-of-range");
 
 	// collect biome tags
-	biome = reg.get_tag_at(pos).get_sub_tag_by_name("Biomes");
+	biome = static_cast<const chunk_tag &>(reg.get_tag_at(pos)).get_sub_tag_by_name("Biomes");
 	if(biome.empty())
 		return 0;
 	return static_cast<byte_array_tag *>(biome.at(0))->at(b_pos);
 }
 
+/*
+ * Fill a 512 x 512 raster with each chunk's biomes
+ */
+void region_file_reader::get_biome_raster(int *raster, unsigned int layer, parallel::POLICY policy) {
+
+	// check arguments
+	if(!raster)
+		throw std::runtime_error("Invalid raster");
+	if(layer >= region_dim::BIOME_HEIGHT)
+		throw std::out_of_range("layer out-of-range");
+
+	// each chunk fills its own 16 x 16 tile, so chunks can be split across workers
+	parallel::for_each(0, region_dim::CHUNK_COUNT, [&](unsigned int pos) {
+		bool volume = false;
+		int biomes[region_dim::BIOME_COUNT];
+		int *tile = raster + (pos / region_dim::CHUNK_WIDTH) * region_dim::BLOCK_WIDTH * region_dim::REGION_WIDTH
+				+ (pos % region_dim::CHUNK_WIDTH) * region_dim::BLOCK_WIDTH;
+
+		// fill missing chunks
+		if(!reg.is_filled(pos)
+				|| !get_chunk_biomes(reg.get_tag_at(pos), biomes, volume)) {
+			for(unsigned int b_z = 0; b_z < region_dim::BLOCK_WIDTH; ++b_z)
+				for(unsigned int b_x = 0; b_x < region_dim::BLOCK_WIDTH; ++b_x)
+					tile[b_z * region_dim::REGION_WIDTH + b_x] = -1;
+			return;
+		}
+
+		// copy rows, expanding 4 x 4 biome cells when needed
+		for(unsigned int b_z = 0; b_z < region_dim::BLOCK_WIDTH; ++b_z)
+			if(volume)
+				for(unsigned int b_x = 0; b_x < region_dim::BLOCK_WIDTH; ++b_x)
+					tile[b_z * region_dim::REGION_WIDTH + b_x] = biomes[(layer * region_dim::BIOME_WIDTH
+							+ b_z / region_dim::BIOME_WIDTH) * region_dim::BIOME_WIDTH + b_x / region_dim::BIOME_WIDTH];
+			else
+				memcpy(tile + b_z * region_dim::REGION_WIDTH, biomes + b_z * region_dim::BLOCK_WIDTH, region_dim::BLOCK_WIDTH * sizeof(int));
+	}, policy);
+}
+
+/*
+ * Fill a 128 x 64 x 128 volume with each chunk's biomes
+ */
+void region_file_reader::get_biome_volume(int *volume, parallel::POLICY policy) {
+	const unsigned int width = region_dim::CHUNK_WIDTH * region_dim::BIOME_WIDTH, center = region_dim::BIOME_WIDTH / 2;
+
+	// check arguments
+	if(!volume)
+		throw std::runtime_error("Invalid volume");
+
+	// each chunk fills its own 4 x 64 x 4 column, so chunks can be split across workers
+	parallel::for_each(0, region_dim::CHUNK_COUNT, [&](unsigned int pos) {
+		bool is_volume = false, filled;
+		int biomes[region_dim::BIOME_COUNT];
+		int *column = volume + (pos / region_dim::CHUNK_WIDTH) * region_dim::BIOME_WIDTH * width
+				+ (pos % region_dim::CHUNK_WIDTH) * region_dim::BIOME_WIDTH;
+
+		filled = reg.is_filled(pos) && get_chunk_biomes(reg.get_tag_at(pos), biomes, is_volume);
+		for(unsigned int y = 0; y < region_dim::BIOME_HEIGHT; ++y)
+			for(unsigned int z = 0; z < region_dim::BIOME_WIDTH; ++z)
+				for(unsigned int x = 0; x < region_dim::BIOME_WIDTH; ++x) {
+					int value = -1;
+
+					// sample 2D biomes at the center of each cell
+					if(filled)
+						value = is_volume ? biomes[(y * region_dim::BIOME_WIDTH + z) * region_dim::BIOME_WIDTH + x]
+								: biomes[(z * region_dim::BIOME_WIDTH + center) * region_dim::BLOCK_WIDTH + x * region_dim::BIOME_WIDTH + center];
+					column[(y * width + z) * width + x] = value;
+				}
+	}, policy);
+}
+
 /*
  * Returns a region's biomes at a given x, z coord
  */
@@ -101,7 +266,7 @@ std::vector<char> region_file_reader::get_biomes_at(unsigned int x, unsigned int
 		throw std::out_of_range("coordinates out-of-range");
 
 	// collect biome tags
-	biome = reg.get_tag_at(pos).get_sub_tag_by_name("Biomes");
+	biome = static_cast<const chunk_tag &>(reg.get_tag_at(pos)).get_sub_tag_by_name("Biomes");
 	if(biome.empty())
 		return biomes;
 	return static_cast<byte_array_tag *>(biome.at(0))->get_value();
@@ -118,7 +283,7 @@ int region_file_reader::get_block_at(unsigned int x, unsigned int z, unsigned in
 	// check coordinates
 	if(pos >= region_dim::CHUNK_COUNT)
 		throw std::out_of_range("coordinates out-of-range");
-	section = reg.get_tag_at(pos).get_sub_tag_by_name("Blocks");
+	section = static_cast<const chunk_tag &>(reg.get_tag_at(pos)).get_sub_tag_by_name("Blocks");
 
 	// return an air block if no blocks exists in a given chunk
 	if(section.empty())
@@ -146,7 +311,7 @@ std::vector<int> region_file_reader::get_blocks_at(unsigned int x, unsigned int
 	unsigned int pos = z * region_dim::CHUNK_WIDTH + x;
 
 	// retrieve chunk data
-	section = reg.get_tag_at(pos).get_sub_tag_by_name("Blocks");
+	section = static_cast<const chunk_tag &>(reg.get_tag_at(pos)).get_sub_tag_by_name("Blocks");
 
 	// return an empty vector if no blocks exists in a given chunk
 	if(section.empty())
@@ -163,6 +328,176 @@ std::vector<int> region_file_reader::get_blocks_at(unsigned int x, unsigned int
 	return all_blocks;
 }
 
+/*
+ * Read a chunk's biomes into a given buffer, returning false if none exist
+ */
+bool region_file_reader::get_chunk_biomes(const chunk_tag &tag, int (&biomes)[region_dim::BIOME_COUNT], bool &volume) {
+	generic_tag *biome = tag.get_level_tag().find("Biomes");
+
+	// check for missing biomes
+	volume = false;
+	if(!biome)
+		return false;
+
+	// biomes are stored per column (bytes pre-1.13, ints pre-1.15) or per 4 x 4 x 4 cell (ints)
+	switch(biome->get_type()) {
+		case generic_tag::BYTE_ARRAY: {
+			byte_array_tag *value = static_cast<byte_array_tag *>(biome);
+			if(value->size() != region_dim::BLOCK_COUNT)
+				return false;
+			for(unsigned int i = 0; i < region_dim::BLOCK_COUNT; ++i)
+				biomes[i] = (unsigned char) value->at(i);
+		} break;
+		case generic_tag::INT_ARRAY: {
+			int_array_tag *value = static_cast<int_array_tag *>(biome);
+			if(value->size() == region_dim::BIOME_COUNT)
+				volume = true;
+			else if(value->size() != region_dim::BLOCK_COUNT)
+				return false;
+			memcpy(biomes, value->get_value().data(), value->size() * sizeof(int));
+		} break;
+		default:
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Read a chunk's height map into a given buffer, returning false if none exist
+ */
+bool region_file_reader::get_chunk_heights(const chunk_tag &tag, const std::string &name, int (&heights)[region_dim::BLOCK_COUNT]) {
+	generic_tag *height = NULL, *height_maps = NULL;
+
+	// legacy chunks store a single int array
+	if(name == "HeightMap") {
+		height = tag.get_level_tag().find(name);
+		if(!height
+				|| height->get_type() != generic_tag::INT_ARRAY
+				|| static_cast<int_array_tag *>(height)->size() != region_dim::BLOCK_COUNT)
+			return false;
+		memcpy(heights, static_cast<int_array_tag *>(height)->get_value().data(), sizeof(heights));
+		return true;
+	}
+
+	// newer chunks store packed long arrays, by name
+	height_maps = tag.get_level_tag().find("Heightmaps");
+	if(!height_maps
+			|| height_maps->get_type() != generic_tag::COMPOUND)
+		return false;
+	height = static_cast<compound_tag *>(height_maps)->find(name);
+	if(!height
+			|| height->get_type() != generic_tag::LONG_ARRAY)
+		return false;
+	packed_array::unpack(static_cast<long_array_tag *>(height)->get_value(), region_dim::BLOCK_COUNT, heights);
+	return true;
+}
+
+/*
+ * Fill the part of a dense array covering a world bounding box that lies within a region with its block ids
+ */
+void region_file_reader::get_blocks_in(const bounding_box &box, int *blocks, parallel::POLICY policy) {
+	bounding_box area;
+	std::vector<unsigned int> chunks;
+	const std::set<std::string> sections = { "Sections" };
+	int reg_x = get_x_coord() * (int) region_dim::REGION_WIDTH,
+			reg_z = get_z_coord() * (int) region_dim::REGION_WIDTH;
+
+	// clip the box to the region
+	if(!box.intersect(bounding_box(reg_x, box.get_min_y(), reg_z, reg_x + (int) region_dim::REGION_WIDTH - 1,
+			box.get_max_y(), reg_z + (int) region_dim::REGION_WIDTH - 1), area))
+		return;
+
+	// collect the filled chunks that intersect the box
+	for(int z = (area.get_min_z() - reg_z) / (int) region_dim::BLOCK_WIDTH;
+			z <= (area.get_max_z() - reg_z) / (int) region_dim::BLOCK_WIDTH; ++z)
+		for(int x = (area.get_min_x() - reg_x) / (int) region_dim::BLOCK_WIDTH;
+				x <= (area.get_max_x() - reg_x) / (int) region_dim::BLOCK_WIDTH; ++x)
+			if(reg.is_filled(z * region_dim::CHUNK_WIDTH + x))
+				chunks.push_back(z * region_dim::CHUNK_WIDTH + x);
+
+	// each chunk covers a disjoint part of the array, so chunks can be split across workers
+	parallel::for_each(0, chunks.size(), [&](unsigned int i) {
+		chunk_tag decoded;
+		const chunk_tag *tag = &reg.get_tag_at(chunks.at(i));
+		std::vector<chunk_section> chunk_sections;
+		int ids[region_dim::SECTION_BLOCK_COUNT];
+		unsigned int x = chunks.at(i) % region_dim::CHUNK_WIDTH, z = chunks.at(i) / region_dim::CHUNK_WIDTH;
+		int w_x = reg_x + (int) (x * region_dim::BLOCK_WIDTH), w_z = reg_z + (int) (z * region_dim::BLOCK_WIDTH);
+		int min_x = std::max(area.get_min_x(), w_x), max_x = std::min(area.get_max_x(), w_x + (int) region_dim::BLOCK_WIDTH - 1),
+				min_z = std::max(area.get_min_z(), w_z), max_z = std::min(area.get_max_z(), w_z + (int) region_dim::BLOCK_WIDTH - 1);
+
+		// decode chunks not yet read, limited to their block data
+		if(!tag->get_root_tag().size()) {
+			std::vector<char> data;
+			read_chunk_data(x, z, data);
+			decode_chunk(data, reg.get_header().get_info_at(chunks.at(i)).get_type(), &sections, decoded);
+			tag = &decoded;
+		}
+
+		// decode each intersecting section once, copying the rows within the box
+		chunk_section::get_sections(*tag, chunk_sections);
+		for(unsigned int j = 0; j < chunk_sections.size(); ++j) {
+			int w_y = chunk_sections.at(j).get_y() * (int) region_dim::SECTION_HEIGHT,
+					min_y = std::max(area.get_min_y(), w_y),
+					max_y = std::min(area.get_max_y(), w_y + (int) region_dim::SECTION_HEIGHT - 1);
+
+			// skip sections outside of the box
+			if(min_y > max_y)
+				continue;
+			chunk_sections.at(j).get_blocks(ids);
+			for(int y = min_y; y <= max_y; ++y)
+				for(int z_pos = min_z; z_pos <= max_z; ++z_pos)
+					memcpy(blocks + box.get_index(min_x, y, z_pos),
+							ids + (((y - w_y) * region_dim::BLOCK_WIDTH + (z_pos - w_z)) * region_dim::BLOCK_WIDTH + (min_x - w_x)),
+							(max_x - min_x + 1) * sizeof(int));
+		}
+	}, policy);
+}
+
+/*
+ * Fill a dense array covering a world bounding box with the block ids of the region files in a given directory
+ */
+void region_file_reader::get_blocks_in(const std::string &directory, const bounding_box &box, std::vector<int> &blocks,
+		parallel::POLICY policy) {
+	world(directory).get_blocks_in(box, blocks, policy);
+}
+
+/*
+ * Returns the file, position and length of a chunk's compressed data
+ */
+bool region_file_reader::get_chunk_location(unsigned int x, unsigned int z, std::string &path, unsigned long long &offset,
+		unsigned int &length) {
+	struct stat status;
+	unsigned int pos = z * region_dim::CHUNK_WIDTH + x;
+
+	// check coordinates
+	if(pos >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+
+	// skip empty chunks
+	chunk_info &info = reg.get_header().get_info_at(pos);
+	if(info.empty())
+		return false;
+
+	// oversized chunks span the whole of their own file
+	if(info.is_external()) {
+		path = get_chunk_path(x, z);
+		if(stat(path.c_str(), &status))
+			throw std::runtime_error("Failed to open external chunk file");
+		offset = 0;
+		length = status.st_size;
+	} else {
+
+		// a source has no file to read from
+		if(source)
+			throw std::runtime_error("Chunk location unavailable for a region source");
+		path = this->path;
+		offset = info.get_offset();
+		length = info.get_length();
+	}
+	return true;
+}
+
 /*
  * Returns a region's chunk tag at a given x, z coord
  */
@@ -189,12 +524,38 @@ int region_file_reader::get_height_at(unsigned int x, unsigned int z, unsigned i
 		throw std::out_of_range("coordinates out-of-range");
 
 	// collect biome tags
-	height = reg.get_tag_at(pos).get_sub_tag_by_name("HeightMap");
+	height = static_cast<const chunk_tag &>(reg.get_tag_at(pos)).get_sub_tag_by_name("HeightMap");
 	if(height.empty())
 		return 0;
 	return static_cast<int_array_tag *>(height.at(0))->at(b_pos);
 }
 
+/*
+ * Fill a 512 x 512 raster with each chunk's height map
+ */
+void region_file_reader::get_heightmap_raster(int *raster, const std::string &name, parallel::POLICY policy) {
+
+	// check arguments
+	if(!raster)
+		throw std::runtime_error("Invalid raster");
+
+	// each chunk fills its own 16 x 16 tile, so chunks can be split across workers
+	parallel::for_each(0, region_dim::CHUNK_COUNT, [&](unsigned int pos) {
+		int heights[region_dim::BLOCK_COUNT];
+		int *tile = raster + (pos / region_dim::CHUNK_WIDTH) * region_dim::BLOCK_WIDTH * region_dim::REGION_WIDTH
+				+ (pos % region_dim::CHUNK_WIDTH) * region_dim::BLOCK_WIDTH;
+
+		// fill missing chunks
+		if(!reg.is_filled(pos)
+				|| !get_chunk_heights(reg.get_tag_at(pos), name, heights))
+			memset(heights, 0, sizeof(heights));
+
+		// copy rows
+		for(unsigned int b_z = 0; b_z < region_dim::BLOCK_WIDTH; ++b_z)
+			memcpy(tile + b_z * region_dim::REGION_WIDTH, heights + b_z * region_dim::BLOCK_WIDTH, region_dim::BLOCK_WIDTH * sizeof(int));
+	}, policy);
+}
+
 /*
  * Returns a region's height map at a given x, z coord
  */
@@ -208,7 +569,7 @@ std::vector<int> region_file_reader::get_heightmap_at(unsigned int x, unsigned i
 		throw std::out_of_range("coordinates out-of-range");
 
 	// collect biome tags
-	height = reg.get_tag_at(pos).get_sub_tag_by_name("HeightMap");
+	height = static_cast<const chunk_tag &>(reg.get_tag_at(pos)).get_sub_tag_by_name("HeightMap");
 	if(height.empty())
 		return heights;
 	return static_cast<int_array_tag *>(height.at(0))->get_value();
@@ -226,10 +587,53 @@ bool region_file_reader::is_filled(unsigned int x, unsigned int z) {
 	return reg.is_filled(pos);
 }
 
+/*
+ * Opens a region file reader's file and reads its header
+ */
+void region_file_reader::open(void) {
+	int x, z;
+
+	// parse the filename for coordinants
+	if(!is_region_file(path, x, z))
+		throw std::runtime_error("Malformated region filename");
+	reg.set_x(x);
+	reg.set_z(z);
+
+	// attempt to open file
+	std::lock_guard<std::mutex> guard(lock);
+	if(file.is_open())
+		file.close();
+	source = NULL;
+	file.clear();
+	file.open(path.c_str(), std::ios::in | std::ios::binary);
+	if(!file.is_open())
+		throw std::runtime_error("Failed to open input file");
+
+	// read header data
+	read_header();
+}
+
+/*
+ * Opens a region source for a region at a given x, z coord and reads its header
+ */
+void region_file_reader::open(region_source &source, int x, int z) {
+	reg.set_x(x);
+	reg.set_z(z);
+
+	// read from the source in place of the file
+	std::lock_guard<std::mutex> guard(lock);
+	if(file.is_open())
+		file.close();
+	this->source = &source;
+
+	// read header data
+	read_header();
+}
+
 /*
  * Read a tag from data
  */
-generic_tag *region_file_reader::parse_tag(byte_stream &stream, bool is_list, char list_type) {
+generic_tag *region_file_reader::parse_tag(byte_stream &stream, bool is_list, char list_type, const std::set<std::string> *filter) {
 	char type;
 	std::string name;
 	generic_tag *tag = NULL, *sub_tag = NULL;
@@ -243,11 +647,17 @@ generic_tag *region_file_reader::parse_tag(byte_stream &stream, bool is_list, ch
 		type = list_type;
 	else {
 		type = read_value<char>(stream);
-		if(type != generic_tag::END) {
-			short name_len = read_value<short>(stream);
-			for(short i = 0; i < name_len; ++i)
-				name += read_value<char>(stream);
-		}
+		if(type != generic_tag::END)
+			name = read_string_value(stream);
+	}
+
+	// skip tags excluded by the filter
+	if(filter
+			&& type != generic_tag::END
+			&& name != "Level"
+			&& !filter->count(name)) {
+		skip_tag(stream, type);
+		return NULL;
 	}
 
 	// parse tag based off type
@@ -286,7 +696,7 @@ generic_tag *region_file_reader::parse_tag(byte_stream &stream, bool is_list, ch
 
 			// parse all subtags and add to list
 			for(int i = 0; i < ele_len; ++i) {
-				sub_tag = parse_tag(stream, true, ele_type);
+				sub_tag = parse_tag(stream, true, ele_type, NULL);
 				lst_tag->push_back(sub_tag);
 			}
 			tag = lst_tag;
@@ -294,14 +704,15 @@ generic_tag *region_file_reader::parse_tag(byte_stream &stream, bool is_list, ch
 		case generic_tag::COMPOUND: {
 			compound_tag *cmp_tag = new compound_tag(name);
 
-			// parse all sub_tags and add to compound
+			// parse all sub_tags and add to compound, filtering those of the level tag
 			do {
-				sub_tag = parse_tag(stream, false, 0);
+				sub_tag = parse_tag(stream, false, 0, (name == "Level") ? filter : NULL);
 				if(!sub_tag)
-					throw std::runtime_error("Failed to parse tag");
+					continue;
 				if(sub_tag->get_type() != generic_tag::END)
 					cmp_tag->push_back(sub_tag);
-			} while(sub_tag->get_type() != generic_tag::END);
+			} while(!sub_tag
+					|| sub_tag->get_type() != generic_tag::END);
 			delete sub_tag;
 			tag = cmp_tag;
 		} break;
@@ -321,33 +732,29 @@ generic_tag *region_file_reader::parse_tag(byte_stream &stream, bool is_list, ch
 /*
  * Read a chunk tag from data
  */
-void region_file_reader::parse_chunk_tag(const std::vector<char> &data, chunk_tag &tag) {
+void region_file_reader::parse_chunk_tag(byte_stream &stream, const std::set<std::string> *filter, chunk_tag &tag) {
 	char type;
-	std::string name;
 	generic_tag *sub_tag = NULL;
 
 	// setup bytestream
-	byte_stream bstream(data);
-	bstream.set_swap(byte_stream::NO_SWAP_ENDIAN);
+	stream.set_swap(byte_stream::NO_SWAP_ENDIAN);
 
 	// parse tags from root
-	type = read_value<char>(bstream);
+	type = read_value<char>(stream);
 	if(type == generic_tag::END)
 		return;
 	else {
-		short name_len = read_value<short>(bstream);
-		for(short i = 0; i < name_len; ++i)
-			name += read_value<char>(bstream);
-		tag.get_root_tag().set_name(name);
+		tag.get_root_tag().set_name(read_string_value(stream));
 		do {
 
 			//parse subtag
-			sub_tag = parse_tag(bstream, false, 0);
+			sub_tag = parse_tag(stream, false, 0, filter);
 			if(!sub_tag)
-				throw std::runtime_error("Failed to parse tag");
+				continue;
 			if(sub_tag->get_type() != generic_tag::END)
 				tag.get_root_tag().push_back(sub_tag);
-		} while(sub_tag->get_type() != generic_tag::END);
+		} while(!sub_tag
+				|| sub_tag->get_type() != generic_tag::END);
 		delete sub_tag;
 	}
 }
@@ -355,120 +762,274 @@ void region_file_reader::parse_chunk_tag(const std::vector<char> &data, chunk_ta
 /*
  * Reads a file into region_file
  */
-void region_file_reader::read(void) {
-	int x, z;
+void region_file_reader::read(parallel::POLICY policy) {
+	bool opened = !is_open();
 
-	// attempt to open file
-	file.open(path.c_str(), std::ios::in | std::ios::binary);
-	if(!file.is_open())
-		throw std::runtime_error("Failed to open input file");
-
-	// parse the filename for coordinants
-	if(!is_region_file(path, x, z))
-		throw std::runtime_error("Malformated region filename");
-	reg.set_x(x);
-	reg.set_z(z);
-
-	// read header data
-	read_header();
+	// open file and read header data, unless already open
+	if(opened)
+		open();
 
 	// read chunk data
-	read_chunks();
+	read_chunks(policy);
 
 	// close file
-	file.close();
+	if(opened)
+		close();
 }
 
 /*
- * Reads chunk data from a file
+ * Reads a region source for a region at a given x, z coord into region_file
  */
-void region_file_reader::read_chunks(void) {
-	chunk_info info;
+void region_file_reader::read(region_source &source, int x, int z, parallel::POLICY policy) {
 
-	// check if file is open
-	if(!file.is_open())
-		throw std::runtime_error("Failed to read chunk data");
+	// open source and read header data
+	open(source, x, z);
 
-	// iterate though header entries, reading in chunks if they exist
-	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
-		info = reg.get_header().get_info_at(i);
+	// read chunk data, then release the source
+	try {
+		read_chunks(policy);
+	} catch(...) {
+		close();
+		throw;
+	}
+	close();
+}
 
-		// skip empty chunks
-		if(info.empty())
-			continue;
+/*
+ * Reads a single chunk at a given x, z coord from an open file into the region
+ */
+void region_file_reader::read_chunk(unsigned int x, unsigned int z) {
+	unsigned int pos = z * region_dim::CHUNK_WIDTH + x;
 
-		// Retrieve raw data
-		size_t length = info.get_length();
-		std::vector<char> raw_data, raw_vec;
-		raw_data.resize(length, 0);
-		file.clear();
-		file.seekg(info.get_offset(), std::ios::beg);
-		file.read((char *)&raw_data[0], length);
-		raw_vec.clear();
-		raw_vec.insert(raw_vec.begin(), raw_data.begin(), raw_data.end());
-
-		// check for compression type
-		switch(info.get_type()) {
-		case chunk_info::GZIP:
-			throw std::runtime_error("Unsupported compression type");
-			break;
-		case chunk_info::ZLIB:
+	// check coordinates
+	if(pos >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
 
-			if(compression::inflate_(raw_vec) == false) {
-				throw std::runtime_error("Failed to uncompress chunk");
-			}
-			break;
-		default:
-			throw std::runtime_error("Unknown compression type");
-			break;
-		}
+	// replace any previously read chunk
+	reg.get_tag_at(pos).clear();
+	read_chunk(x, z, reg.get_tag_at(pos));
+}
+
+/*
+ * Reads a single chunk at a given x, z coord from an open file into a given chunk tag, using a given decode context's buffers
+ */
+void region_file_reader::read_chunk(unsigned int x, unsigned int z, chunk_tag &tag, decode_context &context) {
+	std::vector<char> &data = context.get_raw();
 
-		// use data to fill chunk tag
-		parse_chunk_tag(raw_vec, reg.get_tag_at(i));
+	// read raw data under the file lock, then decode outside of it (into the context's buffers)
+	read_chunk_data(x, z, data);
+	decode_chunk_data(x, z, data, tag, context);
+}
+
+/*
+ * Closes a region file reader's file and opens another, clearing the region read from the previous file
+ */
+void region_file_reader::reopen(const std::string &path) {
+
+	// release the previous file, keeping chunk storage
+	close();
+	reg.clear();
+	this->path = path;
+
+	// open file and read header data
+	open();
+}
+
+/*
+ * Closes a region file reader's file and opens a region source for a region at a given x, z coord, clearing the region
+ * read previously
+ */
+void region_file_reader::reopen(region_source &source, int x, int z) {
+
+	// release the previous file, keeping chunk storage
+	close();
+	reg.clear();
+
+	// open source and read header data
+	open(source, x, z);
+}
+
+/*
+ * Reads the raw (compressed) data of a single chunk at a given x, z coord from an open file
+ */
+void region_file_reader::read_chunk_data(unsigned int x, unsigned int z, std::vector<char> &data) {
+	unsigned int pos = z * region_dim::CHUNK_WIDTH + x;
+
+	// check coordinates
+	if(pos >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+
+	// skip empty chunks
+	data.clear();
+	chunk_info &info = reg.get_header().get_info_at(pos);
+	if(info.empty())
+		return;
+
+	// oversized chunks are stored in their own file
+	if(info.is_external()) {
+		read_external(x, z, data);
+		return;
 	}
+
+	// retrieve raw data
+	std::lock_guard<std::mutex> guard(lock);
+	data.resize(info.get_length(), 0);
+	if(!read_at(info.get_offset(), data.data(), data.size()))
+		throw std::runtime_error("Failed to read chunk data");
+}
+
+/*
+ * Read length bytes at a given offset from the file or source into a given buffer
+ */
+bool region_file_reader::read_at(unsigned long long offset, char *data, unsigned int length) {
+
+	// read from the source, when set
+	if(source)
+		return source->read(offset, data, length);
+
+	// otherwise read from the file
+	if(!file.is_open())
+		return false;
+	file.clear();
+	file.seekg(offset, std::ios::beg);
+	return file.read(data, length).good();
+}
+
+/*
+ * Reads chunk data from a file
+ */
+void region_file_reader::read_chunks(parallel::POLICY policy) {
+
+	// check if file is open
+	if(!is_open())
+		throw std::runtime_error("Failed to read chunk data");
+
+	// give each worker a decode context of its own, kept by the reader, since the parallel policy's threads
+	// only live for one call and would never reuse thread-local contexts
+	while(contexts.size() < (policy == parallel::PARALLEL ? parallel::get_thread_count() : 1))
+		contexts.push_back(std::unique_ptr<decode_context>(new decode_context()));
+
+	// read and decode each chunk independently, through the worker's context, so chunks can be split across workers
+	parallel::for_each_worker(0, region_dim::CHUNK_COUNT, [&](unsigned int i, unsigned int worker) {
+
+		// replace any previously read chunk, skipping empty chunks
+		reg.get_tag_at(i).clear();
+		if(!reg.is_filled(i))
+			return;
+		read_chunk(i % region_dim::CHUNK_WIDTH, i / region_dim::CHUNK_WIDTH, reg.get_tag_at(i), *contexts.at(worker));
+	}, policy);
 }
 
 /*
  * Reads header data from a file
  */
 void region_file_reader::read_header(void) {
-	char type;
-	int value;
+	char data[region_dim::HEADER_OFFSET], record[sizeof(int) + sizeof(char)];
+	unsigned int value;
 
-	// check if file is open
-	if(!file.is_open())
+	// read both header tables at once
+	if(!read_at(0, data, sizeof(data)))
 		throw std::runtime_error("Failed to read header data");
 
-	// read position data into header
+	// read position and timestamp data into header
 	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
-		file.read(reinterpret_cast<char *>(&value), sizeof(value));
+		memcpy(&value, data + (i * sizeof(value)), sizeof(value));
 		convert_endian(value);
 		reg.get_header().get_info_at(i).set_offset(value);
-	}
-
-	// read timestamp data into header
-	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
-		file.read(reinterpret_cast<char *>(&value), sizeof(value));
+		memcpy(&value, data + ((region_dim::CHUNK_COUNT + i) * sizeof(value)), sizeof(value));
 		convert_endian(value);
 		reg.get_header().get_info_at(i).set_modified(value);
 	}
 
 	// read length and compression type data into header
 	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
-		unsigned int offset = reg.get_header().get_info_at(i).get_offset();
+		chunk_info &info = reg.get_header().get_info_at(i);
+		unsigned long long offset = (info.get_offset() >> 8) * region_dim::SECTOR_SIZE,
+				extent = (info.get_offset() & 0xff) * region_dim::SECTOR_SIZE;
 
 		// skip all empty chunks
-		if(!offset)
+		if(!info.get_offset())
 			continue;
 
-		// collect length and compression data
-		file.seekg((offset >> 8) * region_dim::SECTOR_SIZE, std::ios::beg);
-		file.read(reinterpret_cast<char *>(&value), sizeof(value));
+		// collect length and compression data (chunks whose record cannot be read are left without data)
+		info.set_offset(offset + sizeof(record));
+		if(!read_at(offset, record, sizeof(record))) {
+			info.set_length(0);
+			continue;
+		}
+		memcpy(&value, record, sizeof(value));
 		convert_endian(value);
-		reg.get_header().get_info_at(i).set_length(value);
-		file.read(&type, sizeof(type));
-		reg.get_header().get_info_at(i).set_type(type);
-		reg.get_header().get_info_at(i).set_offset((unsigned int) file.tellg());
+
+		// vanilla lengths count the type byte, so keep reads within the chunk's sectors
+		extent = extent > sizeof(record) ? extent - sizeof(record) : 0;
+		info.set_length(value < extent ? value : extent);
+		info.set_type(record[sizeof(value)]);
+	}
+}
+
+/*
+ * Skip over a given number of bytes in stream
+ */
+void region_file_reader::skip_bytes(byte_stream &stream, long long length) {
+
+	// check stream status
+	if(length < 0
+			|| length > stream.available())
+		throw std::runtime_error("Unexpected end of stream");
+	stream.set_position(stream.get_position() + length);
+}
+
+/*
+ * Skip over a tag value of a given type in stream
+ */
+void region_file_reader::skip_tag(byte_stream &stream, char type) {
+
+	// skip value based off type, without allocating it
+	switch(type) {
+		case generic_tag::END:
+			break;
+		case generic_tag::BYTE:
+			skip_bytes(stream, sizeof(char));
+			break;
+		case generic_tag::SHORT:
+			skip_bytes(stream, sizeof(short));
+			break;
+		case generic_tag::INT:
+		case generic_tag::FLOAT:
+			skip_bytes(stream, sizeof(int));
+			break;
+		case generic_tag::LONG:
+		case generic_tag::DOUBLE:
+			skip_bytes(stream, sizeof(long));
+			break;
+		case generic_tag::BYTE_ARRAY:
+			skip_bytes(stream, read_value<int>(stream));
+			break;
+		case generic_tag::STRING:
+			skip_bytes(stream, (unsigned short) read_value<short>(stream));
+			break;
+		case generic_tag::LIST: {
+			char ele_type = read_value<char>(stream);
+			int ele_len = read_value<int>(stream);
+			for(int i = 0; i < ele_len; ++i)
+				skip_tag(stream, ele_type);
+		} break;
+		case generic_tag::COMPOUND: {
+			char sub_type;
+			while((sub_type = read_value<char>(stream)) != generic_tag::END) {
+				skip_bytes(stream, (unsigned short) read_value<short>(stream));
+				skip_tag(stream, sub_type);
+			}
+		} break;
+		case generic_tag::INT_ARRAY:
+			skip_bytes(stream, read_value<int>(stream) * (long long) sizeof(int));
+			break;
+		case generic_tag::LONG_ARRAY:
+			skip_bytes(stream, read_value<int>(stream) * (long long) sizeof(long));
+			break;
+		default:
+			throw std::runtime_error("Unknown tag type");
+			break;
 	}
 }
 
@@ -483,9 +1044,12 @@ std::string region_file_reader::read_string_value(byte_stream &stream) {
 	if(!stream.good())
 		throw std::runtime_error("Unexpected end of stream");
 
-	// retrieve value
+	// retrieve value, straight from the stream buffer
 	str_len = read_value<short>(stream);
-	for(short i = 0; i < str_len; ++i)
-		value += read_value<char>(stream);
+	if(str_len > 0) {
+		value.resize(str_len);
+		if(!stream.read(&value[0], str_len))
+			throw std::runtime_error("Unexpected end of stream");
+	}
 	return value;
 }
@@ -0,0 +1,169 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include "../include/chunk_info.h"
+#include "../include/region_dim.h"
+#include "../include/region_file_transaction.h"
+
+/*
+ * Queue an update at a given x, z coord
+ */
+void region_file_transaction::add(unsigned int x, unsigned int z, const update &value) {
+	unsigned int pos = z * region_dim::CHUNK_WIDTH + x;
+
+	// check coordinates
+	if(pos >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+	updates[pos] = value;
+}
+
+/*
+ * Commit a region file transaction's pending updates
+ */
+void region_file_transaction::commit(parallel::POLICY policy) {
+	compression_policy encoding;
+
+	// commit at the highest level
+	commit(encoding, policy);
+}
+
+/*
+ * Commit a region file transaction's pending updates, deflating chunk tags under a compression policy
+ */
+void region_file_transaction::commit(compression_policy &encoding, parallel::POLICY policy) {
+	std::vector<update *> pending;
+	std::vector<region_file_editor::chunk_write> writes;
+	std::map<unsigned int, update>::iterator iter;
+
+	// lay out writes in chunk order
+	for(iter = updates.begin(); iter != updates.end(); ++iter) {
+		region_file_editor::chunk_write write;
+		write.x = iter->first % region_dim::CHUNK_WIDTH;
+		write.z = iter->first / region_dim::CHUNK_WIDTH;
+		write.type = iter->second.type;
+		write.modified = iter->second.modified;
+		write.remove = iter->second.operation == REMOVE;
+		writes.push_back(write);
+		pending.push_back(&iter->second);
+	}
+
+	// encode chunk tags independently, so they can be split across workers
+	parallel::for_each(0, writes.size(), [&](unsigned int i) {
+		update &value = *pending.at(i);
+
+		// data given as is
+		if(value.operation != REPLACE) {
+			writes.at(i).data = value.data;
+			return;
+		}
+
+		// unmodified chunks are written as read
+		if(value.tag->has_original()) {
+			writes.at(i).data = value.tag->get_original();
+			writes.at(i).type = value.tag->get_original_type();
+			return;
+		}
+
+		// compress chunk
+		writes.at(i).data = value.tag->get_data();
+		if(!encoding.deflate(writes.at(i).data))
+			throw std::runtime_error("Failed to compress chunk");
+		writes.at(i).type = chunk_info::ZLIB;
+	}, policy);
+
+	// write and publish every update together (pending updates are kept if this fails)
+	editor.write_chunks(writes);
+	updates.clear();
+}
+
+/*
+ * Queue a verbatim copy of a chunk's compressed data from a given source region file
+ */
+void region_file_transaction::copy_chunk(region_file_editor &source, unsigned int src_x, unsigned int src_z, unsigned int x,
+		unsigned int z) {
+	update value;
+
+	// check coordinates
+	if(src_z * region_dim::CHUNK_WIDTH + src_x >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("coordinates out-of-range");
+
+	// copying a missing chunk removes it
+	value.tag = NULL;
+	source.read_chunk_data(src_x, src_z, value.data, value.type);
+	value.operation = value.data.empty() ? REMOVE : RAW;
+	value.modified = source.get_region().get_header().get_info_at(src_z * region_dim::CHUNK_WIDTH + src_x).get_modified();
+	add(x, z, value);
+}
+
+/*
+ * Queue the removal of a chunk
+ */
+void region_file_transaction::remove_chunk(unsigned int x, unsigned int z) {
+	update value;
+
+	// queue removal
+	value.operation = REMOVE;
+	value.tag = NULL;
+	value.type = chunk_info::ZLIB;
+	value.modified = 0;
+	add(x, z, value);
+}
+
+/*
+ * Returns a string representation of a region file transaction
+ */
+std::string region_file_transaction::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << "Path: " << editor.get_path() << ", Pending: " << updates.size();
+	return ss.str();
+}
+
+/*
+ * Queue a chunk tag to be encoded and written on commit
+ */
+void region_file_transaction::write_chunk(unsigned int x, unsigned int z, chunk_tag &tag, unsigned int modified) {
+	update value;
+
+	// queue tag
+	value.operation = REPLACE;
+	value.tag = &tag;
+	value.type = chunk_info::ZLIB;
+	value.modified = modified;
+	add(x, z, value);
+}
+
+/*
+ * Queue a chunk's compressed data and compression type to be written as given
+ */
+void region_file_transaction::write_chunk_data(unsigned int x, unsigned int z, const std::vector<char> &data, char type,
+		unsigned int modified) {
+	update value;
+
+	// queue data
+	value.operation = RAW;
+	value.tag = NULL;
+	value.data = data;
+	value.type = type;
+	value.modified = modified;
+	add(x, z, value);
+}
@@ -17,12 +17,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstdio>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
-#include "../include/byte_stream.h"
 #include "../include/chunk_info.h"
-#include "../include/compression.h"
+#include "../include/chunk_tag.h"
 #include "../include/region_dim.h"
 #include "../include/region_file_writer.h"
 
@@ -59,54 +59,87 @@ bool region_file_writer::operator==(const region_file_writer &other) {
  * Write a region file to file
  */
 void region_file_writer::write(void) {
-	unsigned char count;
-	unsigned int offset, remaining;
-	std::vector<char> header_data;
-	unsigned int pos = region_dim::HEADER_OFFSET;
-	byte_stream region_stream(byte_stream::SWAP_ENDIAN);
+	compression_policy policy;
+
+	// write at the highest level
+	write(policy);
+}
+
+/*
+ * Write a region file to file, deflating modified chunks under a compression policy
+ */
+void region_file_writer::write(compression_policy &policy) {
+	int length;
+	char type;
+	unsigned long long count, sector = region_dim::HEADER_OFFSET / region_dim::SECTOR_SIZE;
+	std::vector<char> header_data, padding;
 
 	// attempt to open file
 	file.open(path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
 	if(!file.is_open())
 		throw std::runtime_error("Failed to open output file");
 
-	// iterate through tags
+	// write chunks straight to file, after the header
+	file.seekp(region_dim::HEADER_OFFSET, std::ios::beg);
 	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
+		unsigned int x = i % region_dim::CHUNK_WIDTH, z = i / region_dim::CHUNK_WIDTH;
 
 		// skip unfilled chunks
 		if(!reg.is_filled(i))
 			continue;
 
-		// compress chunk
-		std::vector<char> chunk_data = reg.get_tag_at(i).get_data();
-		compression::deflate_(chunk_data);
+		// compress chunk, unless its original data is unmodified
+		std::vector<char> chunk_data;
+		chunk_tag &tag = reg.get_tag_at(i);
+		chunk_info &info = reg.get_header().get_info_at(i);
+		bool external = info.is_external();
+		if(tag.has_original()) {
+			chunk_data = tag.get_original();
+			type = (unsigned char) tag.get_original_type() & ~chunk_info::EXTERNAL;
+		} else {
+			chunk_data = tag.get_data();
+			policy.deflate(chunk_data);
+			type = (unsigned char) info.get_type() & ~chunk_info::EXTERNAL;
+		}
+
+		// oversized chunks go to their own file, leaving a one-sector stub (stale external files are removed)
+		count = (chunk_data.size() + (sizeof(int) + sizeof(char)) + region_dim::SECTOR_SIZE - 1) / region_dim::SECTOR_SIZE;
+		if(count > region_dim::CHUNK_SECTOR_COUNT) {
+			write_external(x, z, chunk_data);
+			chunk_data.assign(1, 0);
+			type |= chunk_info::EXTERNAL;
+			count = 1;
+		} else if(external)
+			std::remove(get_chunk_path(x, z).c_str());
+		if(sector > region_dim::SECTOR_OFFSET_MAX)
+			throw std::runtime_error("Region file too large");
 
 		// adjust header
-		reg.get_header().get_info_at(i).set_length(chunk_data.size());
-		count = (chunk_data.size() / region_dim::SECTOR_SIZE) + 1;
-		offset = pos / region_dim::SECTOR_SIZE;
-		reg.get_header().get_info_at(i).set_offset((offset << 8) | count);
-
-		// append chunk header & chunk to region stream
-		region_stream << (int) reg.get_header().get_info_at(i).get_length();
-		region_stream << (char) reg.get_header().get_info_at(i).get_type();
-		region_stream << chunk_data;
-
-		// add remaining zeros to fill out sector
-		remaining = region_dim::SECTOR_SIZE - (reg.get_header().get_info_at(i).get_length() % region_dim::SECTOR_SIZE) - (sizeof(int) + sizeof(char));
-		for(unsigned int j = 0; j < remaining; ++j)
-			region_stream << (char) 0;
+		info.set_length(chunk_data.size());
+		info.set_offset((sector << 8) | count);
+		info.set_type(type);
+
+		// write chunk header & chunk, padded out to a whole sector
+		length = chunk_data.size();
+		convert_endian(length);
+		padding.assign((count * region_dim::SECTOR_SIZE) - chunk_data.size() - (sizeof(int) + sizeof(char)), 0);
+		file.write(reinterpret_cast<char *>(&length), sizeof(length));
+		file.write(&type, sizeof(type));
+		file.write(chunk_data.data(), chunk_data.size());
+		file.write(padding.data(), padding.size());
 
 		// move position forward
-		pos += count * region_dim::SECTOR_SIZE;
+		sector += count;
 	}
 
 	// write header to file
 	header_data = reg.get_header().get_data();
+	file.seekp(0, std::ios::beg);
 	file.write(header_data.data(), header_data.size());
-
-	// write chunks to file
-	file.write(region_stream.rdbuf(), region_stream.size());
+	if(!file.good()) {
+		file.close();
+		throw std::runtime_error("Failed to write region file");
+	}
 
 	// close file
 	file.close();
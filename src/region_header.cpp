@@ -133,6 +133,31 @@ void region_header::set_info(const chunk_info (&info)[region_dim::CHUNK_COUNT])
 		this->info[i] = info[i];
 }
 
+/*
+ * Set a region header's info from the raw location and timestamp tables at the start of a region file
+ */
+void region_header::set_data(const std::vector<char> &data) {
+	int value;
+
+	// check for a complete header
+	if(data.size() < region_dim::HEADER_OFFSET)
+		throw std::runtime_error("Malformed region header");
+	byte_stream stream(data);
+	stream.set_swap(byte_stream::NO_SWAP_ENDIAN);
+
+	// extract offsets
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
+		stream >> value;
+		info[i] = chunk_info((unsigned int) value, 0, chunk_info::ZLIB, 0);
+	}
+
+	// extract timestamps
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
+		stream >> value;
+		info[i].set_modified((unsigned int) value);
+	}
+}
+
 /*
  * Set a region header's info at a given index
  */
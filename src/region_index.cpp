@@ -0,0 +1,363 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "../include/byte_stream.h"
+#include "../include/chunk_section.h"
+#include "../include/region_index.h"
+#include "../include/tag/compound_tag.h"
+#include "../include/tag/list_tag.h"
+
+const std::string region_index::EXTENSION = ".idx";
+
+/*
+ * Region index constructor
+ */
+region_index::region_index(void) {
+
+	// initialize attributes
+	memset(entries, 0, sizeof(entries));
+}
+
+/*
+ * Region index constructor
+ */
+region_index::region_index(const region_index &other) {
+
+	// set attributes
+	memcpy(entries, other.entries, sizeof(entries));
+}
+
+/*
+ * Region index assignment operator
+ */
+region_index &region_index::operator=(const region_index &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// set attributes
+	memcpy(entries, other.entries, sizeof(entries));
+	return *this;
+}
+
+/*
+ * Region index equals operator
+ */
+bool region_index::operator==(const region_index &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return !memcmp(entries, other.entries, sizeof(entries));
+}
+
+/*
+ * Add the names of a tag and its sub-tags to a bloom filter
+ */
+void region_index::add_names(const generic_tag *tag, unsigned long long (&names)[BLOOM_WORDS]) {
+	unsigned int bits[3];
+
+	// add named tags (list elements are unnamed)
+	if(!tag->name.empty()) {
+		get_bits(tag->name, bits);
+		for(unsigned int i = 0; i < 3; ++i)
+			names[bits[i] / 64] |= 1ULL << (bits[i] % 64);
+	}
+
+	// add sub-tags based on type
+	switch(tag->get_type()) {
+		case generic_tag::COMPOUND: {
+			const compound_tag *cmp = static_cast<const compound_tag *>(tag);
+			for(unsigned int i = 0; i < cmp->size(); ++i)
+				add_names(cmp->at(i), names);
+		} break;
+		case generic_tag::LIST: {
+			const list_tag *lst = static_cast<const list_tag *>(tag);
+			for(unsigned int i = 0; i < lst->size(); ++i)
+				add_names(lst->at(i), names);
+		} break;
+		default:
+			break;
+	}
+}
+
+/*
+ * Build an entry from a decoded chunk and its uncompressed size
+ */
+void region_index::build_entry(const chunk_tag &tag, unsigned int size, entry &value) {
+	generic_tag *list = NULL;
+	std::vector<int> sections;
+	int heights[region_dim::BLOCK_COUNT];
+
+	// record size and section presence, from section y coords whatever the block encoding
+	value.size = size;
+	value.sections = 0;
+	chunk_section::get_section_coords(tag, sections);
+	for(unsigned int i = 0; i < sections.size(); ++i)
+		if(sections.at(i) >= -32
+				&& sections.at(i) < 32)
+			value.sections |= 1ULL << (sections.at(i) + 32);
+
+	// summarize the height map
+	value.min_height = 0;
+	value.max_height = 0;
+	if(region_file_reader::get_chunk_heights(tag, "HeightMap", heights)
+			|| region_file_reader::get_chunk_heights(tag, "WORLD_SURFACE", heights)) {
+		value.min_height = *std::min_element(heights, heights + region_dim::BLOCK_COUNT);
+		value.max_height = *std::max_element(heights, heights + region_dim::BLOCK_COUNT);
+	}
+
+	// count entities
+	list = tag.get_level_tag().find("Entities");
+	value.entities = (list && list->get_type() == generic_tag::LIST) ? static_cast<list_tag *>(list)->size() : 0;
+	list = tag.get_level_tag().find("TileEntities");
+	value.tile_entities = (list && list->get_type() == generic_tag::LIST) ? static_cast<list_tag *>(list)->size() : 0;
+
+	// record tag names
+	memset(value.names, 0, sizeof(value.names));
+	add_names(&tag.get_root_tag(), value.names);
+}
+
+/*
+ * Returns the bloom filter bit positions of a tag name
+ */
+void region_index::get_bits(const std::string &name, unsigned int (&bits)[3]) {
+	unsigned long long hash = 14695981039346656037ULL;
+
+	// hash the name (fnv-1a), then derive each position by double hashing
+	for(unsigned int i = 0; i < name.size(); ++i) {
+		hash ^= (unsigned char) name.at(i);
+		hash *= 1099511628211ULL;
+	}
+	for(unsigned int i = 0; i < 3; ++i)
+		bits[i] = (unsigned int) (((hash & 0xffffffff) + i * (hash >> 32)) % (BLOOM_WORDS * 64));
+}
+
+/*
+ * Returns a region index's entry at a given chunk index
+ */
+const region_index::entry &region_index::get_entry_at(unsigned int index) {
+
+	// check for valid index
+	if(index >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("index out-of-range");
+	return entries[index];
+}
+
+/*
+ * Returns true if an entry still matches a region header's info at a given chunk index
+ */
+bool region_index::is_current(region_header &header, unsigned int index) {
+	chunk_info &info = header.get_info_at(index);
+
+	// check for valid index
+	if(index >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("index out-of-range");
+
+	// missing chunks are current if the entry is empty
+	if(info.empty())
+		return !entries[index].offset;
+	return entries[index].offset == info.get_offset()
+			&& entries[index].modified == info.get_modified();
+}
+
+/*
+ * Load a region index from file
+ */
+void region_index::load(const std::string &path) {
+	int value;
+	long long wide;
+	std::vector<char> data;
+	entry loaded[region_dim::CHUNK_COUNT];
+
+	// attempt to open file
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if(!file.is_open())
+		throw std::runtime_error("Failed to open input file");
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	byte_stream stream(data);
+	stream.set_swap(byte_stream::NO_SWAP_ENDIAN);
+
+	// check magic and version
+	if(!(stream >> value)
+			|| (unsigned int) value != MAGIC
+			|| !(stream >> value)
+			|| (unsigned int) value != VERSION)
+		throw std::runtime_error("Malformed index file");
+
+	// read each entry, keeping the current entries if any are malformed
+	memset(loaded, 0, sizeof(loaded));
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
+		entry &ent = loaded[i];
+		bool good = (stream >> value);
+		ent.offset = value;
+		good = good && (stream >> value);
+		ent.modified = value;
+		good = good && (stream >> value);
+		ent.size = value;
+		good = good && (stream >> wide);
+		ent.sections = wide;
+		good = good && (stream >> ent.min_height) && (stream >> ent.max_height) && (stream >> value);
+		ent.entities = value;
+		good = good && (stream >> value);
+		ent.tile_entities = value;
+		for(unsigned int j = 0; j < BLOOM_WORDS; ++j) {
+			good = good && (stream >> wide);
+			ent.names[j] = wide;
+		}
+		if(!good)
+			throw std::runtime_error("Malformed index file");
+	}
+	memcpy(entries, loaded, sizeof(entries));
+}
+
+/*
+ * Returns false if a chunk at a given chunk index definitely holds no tag of a given name
+ */
+bool region_index::might_contain(unsigned int index, const std::string &name) {
+	unsigned int bits[3];
+
+	// check for valid index
+	if(index >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("index out-of-range");
+
+	// every position of the name must be set
+	get_bits(name, bits);
+	for(unsigned int i = 0; i < 3; ++i)
+		if(!(entries[index].names[bits[i] / 64] & (1ULL << (bits[i] % 64))))
+			return false;
+	return true;
+}
+
+/*
+ * Load a region's sidecar index, rebuilding stale entries
+ */
+unsigned int region_index::open(region_file_reader &reader, parallel::POLICY policy) {
+	unsigned int count;
+	std::string path = reader.get_path() + EXTENSION;
+
+	// start from the sidecar, if it can be read
+	try {
+		load(path);
+	} catch(std::runtime_error &) {
+		memset(entries, 0, sizeof(entries));
+	}
+
+	// rebuild stale entries, saving them for next time
+	count = refresh(reader, policy);
+	if(count)
+		save(path);
+	return count;
+}
+
+/*
+ * Rebuild the entries that no longer match an open, unfiltered reader's header
+ */
+unsigned int region_index::refresh(region_file_reader &reader, parallel::POLICY policy) {
+	std::vector<unsigned int> stale;
+	region_header &header = reader.get_region().get_header();
+
+	// check for an unfiltered reader, so every tag name is seen
+	if(!reader.get_filter().empty())
+		throw std::runtime_error("Region index requires an unfiltered reader");
+
+	// collect stale entries
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+		if(!is_current(header, i))
+			stale.push_back(i);
+
+	// rebuild each stale entry independently, so chunks can be split across workers
+	parallel::for_each(0, stale.size(), [&](unsigned int i) {
+		chunk_tag tag;
+		std::vector<char> data;
+		unsigned int index = stale.at(i), x = index % region_dim::CHUNK_WIDTH, z = index / region_dim::CHUNK_WIDTH;
+		chunk_info &info = header.get_info_at(index);
+
+		// missing chunks leave an empty entry
+		memset(&entries[index], 0, sizeof(entry));
+		if(info.empty())
+			return;
+
+		// decoding inflates the data in place, leaving its uncompressed size
+		reader.read_chunk_data(x, z, data);
+		reader.decode_chunk_data(x, z, data, tag);
+		build_entry(tag, data.size(), entries[index]);
+		entries[index].offset = info.get_offset();
+		entries[index].modified = info.get_modified();
+	}, policy);
+	return stale.size();
+}
+
+/*
+ * Save a region index to file
+ */
+void region_index::save(const std::string &path) {
+	byte_stream stream(byte_stream::SWAP_ENDIAN);
+
+	// insert magic and version
+	stream << (int) MAGIC;
+	stream << (int) VERSION;
+
+	// insert each entry
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
+		stream << (int) entries[i].offset;
+		stream << (int) entries[i].modified;
+		stream << (int) entries[i].size;
+		stream << (long long) entries[i].sections;
+		stream << entries[i].min_height;
+		stream << entries[i].max_height;
+		stream << (int) entries[i].entities;
+		stream << (int) entries[i].tile_entities;
+		for(unsigned int j = 0; j < BLOOM_WORDS; ++j)
+			stream << (long long) entries[i].names[j];
+	}
+
+	// attempt to write file
+	std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+	if(!file.is_open())
+		throw std::runtime_error("Failed to open output file");
+	file.write(stream.rdbuf(), stream.size());
+	if(!file.good())
+		throw std::runtime_error("Failed to write output file");
+}
+
+/*
+ * Returns a string representation of a region index
+ */
+std::string region_index::to_string(void) {
+	unsigned int count = 0;
+	std::stringstream ss;
+
+	// count indexed chunks
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+		if(entries[i].offset)
+			++count;
+	ss << "Indexed: " << count << "/" << region_dim::CHUNK_COUNT;
+	return ss.str();
+}
@@ -0,0 +1,117 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+#include "../include/region_source.h"
+
+/*
+ * Region source assignment operator
+ */
+region_source &region_source::operator=(const region_source &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	type = other.type;
+	data = other.data;
+	length = other.length;
+	descriptor = other.descriptor;
+	func = other.func;
+	return *this;
+}
+
+/*
+ * Region source equals operator
+ */
+bool region_source::operator==(const region_source &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return type == other.type
+			&& type != CALLBACK
+			&& data == other.data
+			&& length == other.length
+			&& descriptor == other.descriptor;
+}
+
+/*
+ * Read length bytes at a given offset from a region source into a given buffer
+ */
+bool region_source::read(unsigned long long offset, char *data, unsigned int length) {
+	ssize_t count;
+
+	// read based off type
+	switch(type) {
+		case MEMORY:
+			if(offset > this->length
+					|| length > this->length - offset)
+				return false;
+			memcpy(data, this->data + offset, length);
+			break;
+		case DESCRIPTOR:
+
+			// read by position, retrying short and interrupted reads
+			while(length) {
+				count = pread(descriptor, data, length, offset);
+				if(count < 0
+						&& errno == EINTR)
+					continue;
+				if(count <= 0)
+					return false;
+				data += count;
+				offset += count;
+				length -= count;
+			}
+			break;
+		case CALLBACK:
+			return func
+					&& func(offset, data, length);
+		default:
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Returns a string representation of a region source
+ */
+std::string region_source::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	switch(type) {
+		case MEMORY: ss << "MEMORY, Length: " << length;
+			break;
+		case DESCRIPTOR: ss << "DESCRIPTOR, Descriptor: " << descriptor;
+			break;
+		case CALLBACK: ss << "CALLBACK";
+			break;
+		default: ss << "UNKNOWN";
+			break;
+	}
+	return ss.str();
+}
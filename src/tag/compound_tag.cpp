@@ -63,6 +63,18 @@ bool compound_tag::operator==(const generic_tag &other) {
 	return true;
 }
 
+/*
+ * Returns a compound tag's direct sub-tag with a given name, or NULL if none exists
+ */
+generic_tag *compound_tag::find(const std::string &name) const {
+
+	// iterate through sub-tags, without recursing
+	for(unsigned int i = 0; i < value.size(); ++i)
+		if(value.at(i)->name == name)
+			return value.at(i);
+	return NULL;
+}
+
 /*
  * Return a compound tag's data
  */
@@ -0,0 +1,209 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include "../include/parallel.h"
+#include "../include/thread_pool.h"
+
+/*
+ * Thread pool constructor
+ */
+thread_pool::thread_pool(unsigned int count) : failed(false), next(0), pending(0), queued(0), stopping(false) {
+	start(count ? count : parallel::get_thread_count());
+}
+
+/*
+ * Thread pool constructor
+ */
+thread_pool::thread_pool(const thread_pool &other) : failed(false), next(0), pending(0), queued(0), stopping(false) {
+	start(other.get_thread_count());
+}
+
+/*
+ * Thread pool assignment operator
+ */
+thread_pool &thread_pool::operator=(const thread_pool &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// restart with the other pool's worker count
+	wait();
+	stop();
+	start(other.get_thread_count());
+	return *this;
+}
+
+/*
+ * Thread pool equals operator
+ */
+bool thread_pool::operator==(const thread_pool &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return get_thread_count() == other.get_thread_count();
+}
+
+/*
+ * Push a task onto a given worker's queue
+ */
+void thread_pool::push(unsigned int worker, const task &func) {
+
+	// check for valid worker
+	if(worker >= queues.size())
+		throw std::out_of_range("worker out-of-range");
+
+	// count the task before queueing it, so a thief can never take it uncounted, then wake a sleeping worker
+	++pending;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		++queued;
+	}
+	{
+		std::lock_guard<std::mutex> guard(queues.at(worker)->lock);
+		queues.at(worker)->tasks.push_back(func);
+	}
+	ready.notify_one();
+}
+
+/*
+ * Run a worker's loop
+ */
+void thread_pool::run(unsigned int worker) {
+	task func;
+
+	for(;;) {
+
+		// sleep until a task is queued, or the pool stops
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			ready.wait(guard, [&](void) { return queued > 0 || stopping; });
+			if(stopping)
+				return;
+		}
+		if(!take(worker, func))
+			continue;
+
+		// run the task, unless an earlier task failed
+		try {
+			if(!failed)
+				func(worker);
+		} catch(...) {
+			std::lock_guard<std::mutex> guard(lock);
+			if(!error)
+				error = std::current_exception();
+			failed = true;
+		}
+		func = task();
+
+		// signal waiters once the last task finishes
+		if(!--pending) {
+			std::lock_guard<std::mutex> guard(lock);
+			idle.notify_all();
+		}
+	}
+}
+
+/*
+ * Start a given number of workers
+ */
+void thread_pool::start(unsigned int count) {
+	stopping = false;
+	for(unsigned int i = 0; i < count; ++i)
+		queues.push_back(std::unique_ptr<queue>(new queue));
+	for(unsigned int i = 0; i < count; ++i)
+		workers.push_back(std::thread(&thread_pool::run, this, i));
+}
+
+/*
+ * Stop and join all workers
+ */
+void thread_pool::stop(void) {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	ready.notify_all();
+	for(unsigned int i = 0; i < workers.size(); ++i)
+		workers.at(i).join();
+	workers.clear();
+	queues.clear();
+	pending = 0;
+	queued = 0;
+}
+
+/*
+ * Take a task, from the back of a worker's own queue or else from the front of another's
+ */
+bool thread_pool::take(unsigned int worker, task &func) {
+
+	// newest local work first keeps a task's fan-out cache-warm; stealing the oldest work takes the largest pieces
+	for(unsigned int i = 0; i < queues.size(); ++i) {
+		queue &source = *queues.at((worker + i) % queues.size());
+		std::lock_guard<std::mutex> guard(source.lock);
+		if(source.tasks.empty())
+			continue;
+		if(!i) {
+			func = source.tasks.back();
+			source.tasks.pop_back();
+		} else {
+			func = source.tasks.front();
+			source.tasks.pop_front();
+		}
+		--queued;
+		return true;
+	}
+	return false;
+}
+
+/*
+ * Returns a string representation of a thread pool
+ */
+std::string thread_pool::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << queues.size() << " workers, " << pending << " pending";
+	return ss.str();
+}
+
+/*
+ * Wait until every submitted task has finished, rethrowing the first failure
+ */
+void thread_pool::wait(void) {
+	std::exception_ptr failure;
+
+	// wait for the last task
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		idle.wait(guard, [&](void) { return !pending; });
+		failure = error;
+		error = std::exception_ptr();
+		failed = false;
+	}
+
+	// forward the first failure to the caller
+	if(failure)
+		std::rethrow_exception(failure);
+}
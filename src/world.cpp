@@ -0,0 +1,227 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <dirent.h>
+#include <sstream>
+#include <stdexcept>
+#include "../include/region_dim.h"
+#include "../include/world.h"
+
+/*
+ * World constructor
+ */
+world::world(const std::string &directory, unsigned int capacity) : capacity(capacity ? capacity : 1), directory(directory) {
+	scan();
+}
+
+/*
+ * World assignment operator
+ */
+world &world::operator=(const world &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes, dropping any open readers
+	close();
+	capacity = other.capacity;
+	directory = other.directory;
+	filter = other.filter;
+	regions = other.regions;
+	return *this;
+}
+
+/*
+ * World equals operator
+ */
+bool world::operator==(const world &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return capacity == other.capacity
+			&& directory == other.directory
+			&& filter == other.filter
+			&& regions == other.regions;
+}
+
+/*
+ * Close all of a world's open region file readers
+ */
+void world::close(void) {
+	std::lock_guard<std::mutex> guard(lock);
+	reader_index.clear();
+	readers.clear();
+}
+
+/*
+ * Evict the least recently used readers beyond capacity
+ */
+void world::evict(void) {
+	while(readers.size() > capacity) {
+		reader_index.erase(readers.back().first);
+		readers.pop_back();
+	}
+}
+
+/*
+ * Returns a world block id at a given world coord
+ */
+int world::get_block_at(int x, int y, int z) {
+	std::vector<int> blocks;
+
+	// extract a single block box
+	get_blocks_in(bounding_box(x, y, z, x, y, z), blocks);
+	return blocks.front();
+}
+
+/*
+ * Fill a dense array covering a world bounding box with block ids
+ */
+void world::get_blocks_in(const bounding_box &box, std::vector<int> &blocks, parallel::POLICY policy) {
+	coord min = get_region_coord(box.get_min_x(), box.get_min_z()),
+			max = get_region_coord(box.get_max_x(), box.get_max_z());
+
+	// visit each intersecting region that exists
+	blocks.assign(box.get_volume(), 0);
+	for(int r_z = min.second; r_z <= max.second; ++r_z)
+		for(int r_x = min.first; r_x <= max.first; ++r_x) {
+			std::shared_ptr<region_file_reader> reader = get_reader(coord(r_x, r_z));
+			if(reader)
+				reader->get_blocks_in(box, blocks.data(), policy);
+		}
+}
+
+/*
+ * Map a world chunk coord to its region coord and chunk x, z coord within the region
+ */
+void world::get_chunk_coord(int c_x, int c_z, coord &reg, unsigned int &x, unsigned int &z) {
+
+	// regions are 32 chunks wide (arithmetic shifts round negative coords down)
+	reg = coord(c_x >> 5, c_z >> 5);
+	x = c_x & (region_dim::CHUNK_WIDTH - 1);
+	z = c_z & (region_dim::CHUNK_WIDTH - 1);
+}
+
+/*
+ * Returns an open region file reader for a given region coord
+ */
+std::shared_ptr<region_file_reader> world::get_reader(const coord &reg) {
+	std::shared_ptr<region_file_reader> reader;
+	std::map<coord, std::string>::iterator path = regions.find(reg);
+
+	// check for a missing region
+	if(path == regions.end())
+		return reader;
+
+	// move an open reader to the front
+	std::lock_guard<std::mutex> guard(lock);
+	std::map<coord, reader_list::iterator>::iterator entry = reader_index.find(reg);
+	if(entry != reader_index.end()) {
+		readers.splice(readers.begin(), readers, entry->second);
+		return entry->second->second;
+	}
+
+	// otherwise open the reader, evicting the least recently used
+	reader = std::make_shared<region_file_reader>(path->second);
+	reader->set_filter(filter);
+	reader->open();
+	readers.push_front(std::make_pair(reg, reader));
+	reader_index[reg] = readers.begin();
+	evict();
+	return reader;
+}
+
+/*
+ * Reads a single chunk at a given world chunk coord into a given chunk tag
+ */
+bool world::read_chunk(int c_x, int c_z, chunk_tag &tag) {
+	coord reg;
+	unsigned int x, z;
+	std::shared_ptr<region_file_reader> reader;
+
+	// find the region containing the chunk
+	get_chunk_coord(c_x, c_z, reg, x, z);
+	reader = get_reader(reg);
+	if(!reader
+			|| !reader->is_filled(x, z))
+		return false;
+	reader->read_chunk(x, z, tag);
+	return true;
+}
+
+/*
+ * Scan a world's region directory, indexing its region files by coord
+ */
+void world::scan(void) {
+	DIR *dir = NULL;
+	struct dirent *entry = NULL;
+	std::string prefix = directory;
+
+	// drop any previous index
+	close();
+	regions.clear();
+
+	// attempt to open directory
+	dir = opendir(directory.c_str());
+	if(!dir)
+		throw std::runtime_error("Failed to open world directory");
+	if(!prefix.empty()
+			&& prefix.at(prefix.size() - 1) != '/')
+		prefix += '/';
+
+	// index each region file by coord
+	while((entry = readdir(dir))) {
+		int x, z;
+		if(region_file::is_region_file(entry->d_name, x, z))
+			regions[coord(x, z)] = prefix + entry->d_name;
+	}
+	closedir(dir);
+}
+
+/*
+ * Sets a world's max number of open region file readers
+ */
+void world::set_capacity(unsigned int capacity) {
+	std::lock_guard<std::mutex> guard(lock);
+	this->capacity = capacity ? capacity : 1;
+	evict();
+}
+
+/*
+ * Sets a world's tag filter
+ */
+void world::set_filter(const std::set<std::string> &filter) {
+	close();
+	this->filter = filter;
+}
+
+/*
+ * Returns a string representation of a world
+ */
+std::string world::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << directory << " (" << regions.size() << " regions, " << readers.size() << "/" << capacity << " open)";
+	return ss.str();
+}
@@ -0,0 +1,299 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "../include/region_dim.h"
+#include "../include/region_file.h"
+#include "../include/world_census.h"
+
+/*
+ * World census assignment operator
+ */
+world_census &world_census::operator=(const world_census &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	regions = other.regions;
+	return *this;
+}
+
+/*
+ * World census equals operator
+ */
+bool world_census::operator==(const world_census &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	if(regions.size() != other.regions.size())
+		return false;
+	for(unsigned int i = 0; i < regions.size(); ++i)
+		if(regions.at(i).coord != other.regions.at(i).coord
+				|| regions.at(i).chunks != other.regions.at(i).chunks
+				|| regions.at(i).compressed_size != other.regions.at(i).compressed_size
+				|| regions.at(i).sectors != other.regions.at(i).sectors
+				|| regions.at(i).file_sectors != other.regions.at(i).file_sectors
+				|| regions.at(i).min_modified != other.regions.at(i).min_modified
+				|| regions.at(i).max_modified != other.regions.at(i).max_modified
+				|| regions.at(i).invalid != other.regions.at(i).invalid)
+			return false;
+	return true;
+}
+
+/*
+ * Count a single region file, from its header and, optionally, its chunk prefixes
+ */
+void world_census::count_region(const std::string &path, bool prefixes, region_count &count) {
+	region_header header;
+	unsigned long long file_size;
+	std::vector<unsigned int> order;
+	std::vector<char> data(region_dim::HEADER_OFFSET, 0);
+
+	// attempt to open file
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if(!file.is_open())
+		throw std::runtime_error("Failed to open input file");
+	file.seekg(0, std::ios::end);
+	file_size = (unsigned long long) file.tellg();
+	count.file_sectors = (file_size + region_dim::SECTOR_SIZE - 1) / region_dim::SECTOR_SIZE;
+	count.sectors = region_dim::HEADER_OFFSET / region_dim::SECTOR_SIZE;
+	count.chunks = 0;
+	count.invalid = 0;
+	count.compressed_size = 0;
+	count.min_modified = 0;
+	count.max_modified = 0;
+
+	// files too short for a header hold no chunks
+	if(file_size < region_dim::HEADER_OFFSET) {
+		count.sectors = 0;
+		return;
+	}
+	file.seekg(0, std::ios::beg);
+	file.read(&data[0], data.size());
+	header.set_data(data);
+
+	// tally chunk locations and timestamps
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i) {
+		chunk_info &info = header.get_info_at(i);
+		unsigned long long offset = (info.get_offset() >> 8), sectors = (info.get_offset() & 0xff);
+
+		// skip empty chunks
+		if(info.empty())
+			continue;
+		++count.chunks;
+		if(count.chunks == 1
+				|| info.get_modified() < count.min_modified)
+			count.min_modified = info.get_modified();
+		count.max_modified = std::max(count.max_modified, info.get_modified());
+		if((offset + sectors) * region_dim::SECTOR_SIZE > file_size
+				|| offset < (region_dim::HEADER_OFFSET / region_dim::SECTOR_SIZE)) {
+			++count.invalid;
+			continue;
+		}
+		count.sectors += sectors;
+		if(prefixes)
+			order.push_back(i);
+		else
+			count.compressed_size += sectors * region_dim::SECTOR_SIZE;
+	}
+
+	// read chunk prefixes in file order, so the reads are sequential
+	std::sort(order.begin(), order.end(), [&](unsigned int left, unsigned int right) {
+		return header.get_info_at(left).get_offset() < header.get_info_at(right).get_offset();
+	});
+	for(unsigned int i = 0; i < order.size(); ++i) {
+		char prefix[5];
+		unsigned int length, type;
+		chunk_info &info = header.get_info_at(order.at(i));
+
+		// the length covers the compression type byte and data, which must fit in the allocated sectors
+		file.seekg((info.get_offset() >> 8) * (unsigned long long) region_dim::SECTOR_SIZE, std::ios::beg);
+		file.read(prefix, sizeof(prefix));
+		length = ((unsigned char) prefix[0] << 24) | ((unsigned char) prefix[1] << 16)
+				| ((unsigned char) prefix[2] << 8) | (unsigned char) prefix[3];
+		type = (unsigned char) prefix[4] & ~chunk_info::EXTERNAL;
+		if(!file.good()
+				|| !length
+				|| length + 4ULL > (info.get_offset() & 0xff) * (unsigned long long) region_dim::SECTOR_SIZE
+				|| (type != chunk_info::GZIP && type != chunk_info::ZLIB)) {
+			++count.invalid;
+			continue;
+		}
+
+		// oversized chunks leave a stub, their data living in their own file
+		if((unsigned char) prefix[4] & chunk_info::EXTERNAL) {
+			struct stat status;
+			std::string chunk_path;
+			try {
+				chunk_path = region_file::get_chunk_path(path, order.at(i) % region_dim::CHUNK_WIDTH,
+						order.at(i) / region_dim::CHUNK_WIDTH);
+			} catch(std::runtime_error &) {
+				++count.invalid;
+				continue;
+			}
+			if(stat(chunk_path.c_str(), &status)) {
+				++count.invalid;
+				continue;
+			}
+			count.compressed_size += status.st_size;
+		} else
+			count.compressed_size += length - 1;
+	}
+}
+
+/*
+ * Returns a census's total chunk count
+ */
+unsigned long long world_census::get_chunk_count(void) {
+	unsigned long long total = 0;
+
+	// sum region counts
+	for(unsigned int i = 0; i < regions.size(); ++i)
+		total += regions.at(i).chunks;
+	return total;
+}
+
+/*
+ * Returns a census's total compressed chunk data size
+ */
+unsigned long long world_census::get_compressed_size(void) {
+	unsigned long long total = 0;
+
+	// sum region sizes
+	for(unsigned int i = 0; i < regions.size(); ++i)
+		total += regions.at(i).compressed_size;
+	return total;
+}
+
+/*
+ * Returns a census's total sector count
+ */
+unsigned long long world_census::get_file_sector_count(void) {
+	unsigned long long total = 0;
+
+	// sum region sectors
+	for(unsigned int i = 0; i < regions.size(); ++i)
+		total += regions.at(i).file_sectors;
+	return total;
+}
+
+/*
+ * Returns a census's total invalid chunk count
+ */
+unsigned long long world_census::get_invalid_count(void) {
+	unsigned long long total = 0;
+
+	// sum region counts
+	for(unsigned int i = 0; i < regions.size(); ++i)
+		total += regions.at(i).invalid;
+	return total;
+}
+
+/*
+ * Returns a census's newest chunk timestamp
+ */
+unsigned int world_census::get_max_modified(void) {
+	unsigned int modified = 0;
+
+	// find the newest region timestamp
+	for(unsigned int i = 0; i < regions.size(); ++i)
+		modified = std::max(modified, regions.at(i).max_modified);
+	return modified;
+}
+
+/*
+ * Returns a census's oldest chunk timestamp
+ */
+unsigned int world_census::get_min_modified(void) {
+	bool found = false;
+	unsigned int modified = 0;
+
+	// find the oldest timestamp of the regions holding chunks
+	for(unsigned int i = 0; i < regions.size(); ++i)
+		if(regions.at(i).chunks
+				&& (!found || regions.at(i).min_modified < modified)) {
+			modified = regions.at(i).min_modified;
+			found = true;
+		}
+	return modified;
+}
+
+/*
+ * Returns a census's total allocated sector count
+ */
+unsigned long long world_census::get_sector_count(void) {
+	unsigned long long total = 0;
+
+	// sum region sectors
+	for(unsigned int i = 0; i < regions.size(); ++i)
+		total += regions.at(i).sectors;
+	return total;
+}
+
+/*
+ * Returns a census's sector utilization
+ */
+double world_census::get_utilization(void) {
+	unsigned long long file_sectors = get_file_sector_count();
+	return file_sectors ? (double) get_sector_count() / file_sectors : 0.0;
+}
+
+/*
+ * Take a census of every region in a world
+ */
+void world_census::take(world &wld, bool prefixes, parallel::POLICY policy) {
+	std::vector<std::string> paths;
+	std::map<world::coord, std::string>::const_iterator iter;
+
+	// lay out one census per region, in region coord order
+	regions.clear();
+	for(iter = wld.get_regions().begin(); iter != wld.get_regions().end(); ++iter) {
+		region_count count = region_count();
+		count.coord = iter->first;
+		regions.push_back(count);
+		paths.push_back(iter->second);
+	}
+
+	// each region is counted independently, so regions can be split across workers
+	parallel::for_each(0, regions.size(), [&](unsigned int i) {
+		count_region(paths.at(i), prefixes, regions.at(i));
+	}, policy);
+}
+
+/*
+ * Returns a string representation of a world census
+ */
+std::string world_census::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << "Regions: " << regions.size() << ", Chunks: " << get_chunk_count() << " (" << get_invalid_count() << " invalid)"
+			<< ", Compressed: " << get_compressed_size() << " bytes, Sectors: " << get_sector_count() << "/"
+			<< get_file_sector_count() << ", Modified: " << get_min_modified() << " - " << get_max_modified();
+	return ss.str();
+}
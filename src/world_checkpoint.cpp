@@ -0,0 +1,206 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "../include/byte_stream.h"
+#include "../include/region_dim.h"
+#include "../include/world_checkpoint.h"
+
+/*
+ * World checkpoint assignment operator
+ */
+world_checkpoint &world_checkpoint::operator=(const world_checkpoint &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	timestamps = other.timestamps;
+	return *this;
+}
+
+/*
+ * World checkpoint equals operator
+ */
+bool world_checkpoint::operator==(const world_checkpoint &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return timestamps == other.timestamps;
+}
+
+/*
+ * Returns a checkpoint's timestamp of a chunk at a given region coord and chunk index
+ */
+unsigned int world_checkpoint::get_modified(const world::coord &reg, unsigned int index) const {
+	std::map<world::coord, std::vector<unsigned int>>::const_iterator iter = timestamps.find(reg);
+
+	// check for valid index
+	if(index >= region_dim::CHUNK_COUNT)
+		throw std::out_of_range("index out-of-range");
+	return iter == timestamps.end() ? 0 : iter->second.at(index);
+}
+
+/*
+ * Load a checkpoint from file
+ */
+void world_checkpoint::load(const std::string &path) {
+	int value, x, z, count;
+	std::vector<char> data;
+
+	// attempt to open file
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if(!file.is_open())
+		throw std::runtime_error("Failed to open input file");
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	byte_stream stream(data);
+	stream.set_swap(byte_stream::NO_SWAP_ENDIAN);
+
+	// check magic and version
+	if(!(stream >> value)
+			|| (unsigned int) value != MAGIC
+			|| !(stream >> value)
+			|| (unsigned int) value != VERSION
+			|| !(stream >> count)
+			|| count < 0)
+		throw std::runtime_error("Malformed checkpoint file");
+
+	// read each region's timestamps
+	timestamps.clear();
+	for(int i = 0; i < count; ++i) {
+		std::vector<unsigned int> modified(region_dim::CHUNK_COUNT, 0);
+		if(!(stream >> x)
+				|| !(stream >> z))
+			throw std::runtime_error("Malformed checkpoint file");
+		for(unsigned int j = 0; j < region_dim::CHUNK_COUNT; ++j) {
+			if(!(stream >> value))
+				throw std::runtime_error("Malformed checkpoint file");
+			modified.at(j) = (unsigned int) value;
+		}
+		timestamps[world::coord(x, z)].swap(modified);
+	}
+}
+
+/*
+ * Decode and visit every chunk of a world whose header timestamp differs from a previous checkpoint
+ */
+unsigned int world_checkpoint::read_changed(world &wld, const world_checkpoint &previous, world_checkpoint &current,
+		const std::function<void(int, int, chunk_tag &)> &func, parallel::POLICY policy) {
+	unsigned int count = 0, readers = 0;
+	std::vector<std::pair<std::shared_ptr<region_file_reader>, unsigned int>> changed;
+	std::map<world::coord, std::string>::const_iterator iter;
+
+	// decode the changed chunks found so far, each independently, so chunks can be split across workers
+	std::function<void(void)> flush = [&](void) {
+		parallel::for_each(0, changed.size(), [&](unsigned int i) {
+			chunk_tag tag;
+			region_file_reader &reader = *changed.at(i).first;
+			unsigned int x = changed.at(i).second % region_dim::CHUNK_WIDTH, z = changed.at(i).second / region_dim::CHUNK_WIDTH;
+
+			reader.read_chunk(x, z, tag);
+			func(reader.get_x_coord() * (int) region_dim::CHUNK_WIDTH + (int) x,
+					reader.get_z_coord() * (int) region_dim::CHUNK_WIDTH + (int) z, tag);
+		}, policy);
+		count += changed.size();
+		changed.clear();
+		readers = 0;
+	};
+
+	// compare each region header against the previous checkpoint, holding no more readers open than the world would
+	current.clear();
+	for(iter = wld.get_regions().begin(); iter != wld.get_regions().end(); ++iter) {
+		bool found = false;
+		std::shared_ptr<region_file_reader> reader = wld.get_reader(iter->first);
+		region_header &header = reader->get_region().get_header();
+
+		current.set_region(iter->first, header);
+		for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+			if(!header.get_info_at(i).empty()
+					&& header.get_info_at(i).get_modified() != previous.get_modified(iter->first, i)) {
+				changed.push_back(std::make_pair(reader, i));
+				found = true;
+			}
+		if(found
+				&& ++readers >= wld.get_capacity())
+			flush();
+	}
+	flush();
+	return count;
+}
+
+/*
+ * Save a checkpoint to file
+ */
+void world_checkpoint::save(const std::string &path) {
+	byte_stream stream(byte_stream::SWAP_ENDIAN);
+	std::map<world::coord, std::vector<unsigned int>>::iterator iter;
+
+	// insert magic, version and region count
+	stream << (int) MAGIC;
+	stream << (int) VERSION;
+	stream << (int) timestamps.size();
+
+	// insert each region's timestamps
+	for(iter = timestamps.begin(); iter != timestamps.end(); ++iter) {
+		stream << iter->first.first;
+		stream << iter->first.second;
+		for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+			stream << (int) iter->second.at(i);
+	}
+
+	// attempt to write file
+	std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+	if(!file.is_open())
+		throw std::runtime_error("Failed to open output file");
+	file.write(stream.rdbuf(), stream.size());
+	if(!file.good())
+		throw std::runtime_error("Failed to write output file");
+}
+
+/*
+ * Record a region header's chunk timestamps at a given region coord
+ */
+void world_checkpoint::set_region(const world::coord &reg, region_header &header) {
+	std::vector<unsigned int> &modified = timestamps[reg];
+
+	// missing chunks are recorded as 0
+	modified.assign(region_dim::CHUNK_COUNT, 0);
+	for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+		if(!header.get_info_at(i).empty())
+			modified.at(i) = header.get_info_at(i).get_modified();
+}
+
+/*
+ * Returns a string representation of a world checkpoint
+ */
+std::string world_checkpoint::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << "Regions: " << timestamps.size();
+	return ss.str();
+}
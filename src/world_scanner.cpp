@@ -0,0 +1,117 @@
+/*
+ * LibAnvil
+ * Copyright (C) 2012 - 2020 David Jolly
+ * ----------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include "../include/region_dim.h"
+#include "../include/world_scanner.h"
+
+/*
+ * World scanner assignment operator
+ */
+world_scanner &world_scanner::operator=(const world_scanner &other) {
+
+	// check for self
+	if(this == &other)
+		return *this;
+
+	// assign attributes
+	pool = other.pool;
+	wld = other.wld;
+	return *this;
+}
+
+/*
+ * World scanner equals operator
+ */
+bool world_scanner::operator==(const world_scanner &other) {
+
+	// check for self
+	if(this == &other)
+		return true;
+
+	// check attributes
+	return pool == other.pool
+			&& wld == other.wld;
+}
+
+/*
+ * Visit every chunk of a world
+ */
+void world_scanner::scan(const visitor &func) {
+	std::map<world::coord, std::string>::const_iterator iter;
+
+	// check for a world
+	if(!wld)
+		throw std::runtime_error("World scanner has no world");
+
+	// one i/o task per region, reading raw chunk data in file order
+	for(iter = wld->get_regions().begin(); iter != wld->get_regions().end(); ++iter) {
+		world::coord reg = iter->first;
+		pool.submit([this, reg, &func](unsigned int worker) {
+			std::vector<unsigned int> order;
+			std::shared_ptr<region_file_reader> reader = wld->get_reader(reg);
+
+			// check for a removed region
+			if(!reader)
+				return;
+
+			// read filled chunks in file order, so the reads are sequential
+			region_header &header = reader->get_region().get_header();
+			for(unsigned int i = 0; i < region_dim::CHUNK_COUNT; ++i)
+				if(!header.get_info_at(i).empty())
+					order.push_back(i);
+			std::sort(order.begin(), order.end(), [&](unsigned int left, unsigned int right) {
+				return header.get_info_at(left).get_offset() < header.get_info_at(right).get_offset();
+			});
+
+			// fan out one decode task per chunk, queued locally (and so first in line to be stolen)
+			for(unsigned int i = 0; i < order.size(); ++i) {
+				unsigned int x = order.at(i) % region_dim::CHUNK_WIDTH, z = order.at(i) / region_dim::CHUNK_WIDTH;
+				std::shared_ptr<std::vector<char>> data = std::make_shared<std::vector<char>>();
+				reader->read_chunk_data(x, z, *data);
+				pool.submit(worker, [reader, data, reg, x, z, &func](unsigned int worker) {
+					chunk_tag tag;
+
+					// decode and visit the chunk, releasing its raw data first
+					reader->decode_chunk_data(x, z, *data, tag);
+					std::vector<char>().swap(*data);
+					func(worker, reg.first * (int) region_dim::CHUNK_WIDTH + (int) x,
+							reg.second * (int) region_dim::CHUNK_WIDTH + (int) z, tag);
+				});
+			}
+		});
+	}
+
+	// wait for every chunk, forwarding the first failure
+	pool.wait();
+}
+
+/*
+ * Returns a string representation of a world scanner
+ */
+std::string world_scanner::to_string(void) {
+	std::stringstream ss;
+
+	// form string representation
+	ss << (wld ? wld->to_string() : "(no world)") << ", " << pool.to_string();
+	return ss.str();
+}